@@ -22,6 +22,42 @@ SGB_DisplayInitInfo MainDisplay::GetInitInfo()
 	//The SDL_Color field are associated with a {r, g, b, a} set
 	info.RendererBackgroundColor = { 0xa0, 0xa0, 0xa0, 0xff };
 	info.RendererDefaultDrawColor = { 0x00, 0x00, 0x00, 0xff };
+	//Screen updates follow the frame rate (no fixed timestep)
+	info.FixedTimestep = false;
+	info.FixedUpdateRate = 60;
+	info.MaxUpdateStepsPerFrame = 5;
+	//Sleep between frames instead of spinning the main loop
+	info.PaceFrames = true;
+	//Measure the time of each loop phase (see GetFrameProfile())
+	info.EnableProfiler = false;
+	//Set a path to record a chrome://tracing file
+	info.TraceFilePath = NULL;
+	//Follow the power state and missed frames at runtime
+	info.AdaptiveFrameRate = true;
+	info.MinimumFrameRate = 20;
+	info.BatteryFrameRate = 0;
+	info.PowerCheckInterval = 5000;
+	//Render to an offscreen surface instead of a window
+	info.Headless = false;
+	//Worker threads for the job system (0 = one less than the CPU cores)
+	info.JobWorkerCount = 0;
+	//Unload the previous screen after showing the next, within a memory budget (0 = no limit)
+	info.DeferScreenUnload = true;
+	info.ScreenMemoryBudget = 0;
+	//Keep named screens loaded after leaving them (0 bytes = no cache)
+	info.ScreenCacheBudget = 0;
+	info.ScreenCacheMaxScreens = 4;
+	//Time each loop cycle may spend creating queued textures, in microseconds
+	info.TextureUploadBudget = 2000;
+	//File where screen load durations are kept to estimate the next loads
+	info.LoadingHistoryPath = NULL;
+	//Record the rectangle helpers and render them grouped by color
+	info.BatchDraws = false;
+	//Keep released shared resources loaded for a while (in milliseconds), within a memory budget (0 = no limit)
+	info.ResourceUnloadDelay = 10000;
+	info.ResourceCacheBudget = 0;
+	//Only render frames invalidated by the screens, sleeping otherwise
+	info.RenderOnChange = false;
 
 	return info;
 }
@@ -1,5 +1,11 @@
 #include "TestLoading.h"
 
+TestLoading::TestLoading()
+{
+	//only the latest progress is shown, no need to queue every status
+	SetLoadingStatusHistory(false);
+}
+
 void TestLoading::ScreenShow()
 {
 	//A very noticeable Fuchsia
@@ -14,12 +20,14 @@ void TestLoading::Update()
 	//Checking and processing loading status
 	SGB_LoadingScreenStatus stats;
 
-	//Using a while() to process all queued status messages,
-	//using if() works however it may cause a slow down on the
-	//status process if there is more than one new status per
-	//loop cycle cycle.
-	while (PullLoadingStatus(&stats) == SGB_SUCCESS)
+	//Only the newest status matters for a progress bar, so any
+	//older status sent on the same loop cycle is skipped. Use
+	//PullLoadingStatus() or DrainLoadingStatus() to get all of them.
+	if (PullLatestLoadingStatus(&stats) == SGB_SUCCESS)
 	{
+		//the bar moved, only needed with SGB_DisplayInitInfo::RenderOnChange
+		Invalidate();
+
 		//at each PROGRESS_THRESHOLD% we output the progress on the console
 		const int PROGRESS_THRESHOLD = 5;
 
@@ -28,7 +36,17 @@ void TestLoading::Update()
 
 		if ((iProgress / PROGRESS_THRESHOLD) != (iLastProgress / PROGRESS_THRESHOLD))
 		{
-			printf("Progress: %.0f%%, Status: %s\n", stats.progress * 100, stats.status);
+			Uint32 remaining = 0;
+
+			if (GetLoadingProgress()->GetEstimatedRemainingTicks(&remaining) == SGB_SUCCESS)
+			{
+				printf("Progress: %.0f%%, Status: %s (about %ums left)\n",
+					stats.progress * 100, stats.status, remaining);
+			}
+			else
+			{
+				printf("Progress: %.0f%%, Status: %s\n", stats.progress * 100, stats.status);
+			}
 		}
 
 		_lastProgress = stats.progress;
@@ -5,6 +5,8 @@
 class TestLoading :
 	public SGB_LoadingScreen
 {
+public:
+	TestLoading();
 
 private:
 
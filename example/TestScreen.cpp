@@ -2,21 +2,31 @@
 
 void TestScreen::LoadScreen()
 {
-	//Getting states
-	keyStates = SDL_GetKeyboardState(NULL);
-
 	//color for the boxes
 	_boxColor = GetColor(0xff, 0x40, 0x40);
 
 	SGB_LoadingScreenStatus loadingStatus;
 
+	//a single task, parallel loads would register one per job
+	auto progress = GetLoadingProgress();
+	auto barTask = progress->AddTask(1.0f);
+
 	const int BAR_ITERATIONS = 1000;
 	const float BAR_ITERATIONS_F = BAR_ITERATIONS * 1.0f;
 	// the bar will scroll in 5 seconds
 	const int ITERATION_DELAY = 5000 / BAR_ITERATIONS;
 
+	//shown as a span on the trace file, when recording one
+	SGB_TRACE_SCOPE("TestScreen::LoadScreen loop");
+
 	for (int i = 0; i < BAR_ITERATIONS; i++)
 	{
+		//another screen was set meanwhile, this one won't be shown
+		if (IsLoadCancelled())
+		{
+			return;
+		}
+
 		loadingStatus.progress = (float)(i / BAR_ITERATIONS_F);
 		snprintf(
 			loadingStatus.status, 
@@ -24,6 +34,7 @@ void TestScreen::LoadScreen()
 			"Test loading %d of %d...", 
 			i, BAR_ITERATIONS);
 		PushLoadingStatus(loadingStatus);
+		progress->SetTaskProgress(barTask, loadingStatus.progress);
 		SDL_Delay(ITERATION_DELAY);
 	}
 
@@ -42,15 +53,20 @@ void TestScreen::ScreenShow()
 	printf("Showing FPS as blocks. Press ESC to finish.\n");
 }
 
-void TestScreen::Update()
+void TestScreen::HandleEvents(const std::vector<SDL_Event>& events)
 {
-	SDL_PumpEvents();
-
-	if (keyStates[SDL_SCANCODE_ESCAPE])
+	for (auto& event : events)
 	{
-		_display->StopRunning();
+		if (event.type == SDL_KEYDOWN && 
+			event.key.keysym.sym == SDLK_ESCAPE)
+		{
+			_display->StopRunning();
+		}
 	}
-	
+}
+
+void TestScreen::Update()
+{
 	SGB_DisplayLoopStats stats = _display->GetLoopStats();
 
 	_elapsedCounter += stats.DeltaSeconds;
@@ -10,13 +10,12 @@ class TestScreen :
 public:
 
 	virtual void LoadScreen() override;
+	virtual void HandleEvents(const std::vector<SDL_Event>& events) override;
 	virtual void Update() override;
 	virtual void Draw() override;
 	virtual void ScreenShow() override;
 
 	float _elapsedCounter;
 	SDL_Color _boxColor;
-
-	const Uint8* keyStates;
 };
 
@@ -8,3 +8,12 @@
 #include "SGB_Screen.h"
 #include "SGB_LoadingScreen.h"
 #include "SGB_LoadingQueue.h"
+#include "SGB_LoadingProgress.h"
+#include "SGB_Tracer.h"
+#include "SGB_TimeSource.h"
+#include "SGB_JobSystem.h"
+#include "SGB_DrawBatch.h"
+#include "SGB_RenderStateGuard.h"
+#include "SGB_TextureAtlas.h"
+#include "SGB_SpriteBatch.h"
+#include "SGB_ResourceManager.h"
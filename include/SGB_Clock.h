@@ -0,0 +1,27 @@
+#pragma once
+
+#include "SGB_SDL.h"
+
+/*! \brief Defines how many nanoseconds there are in a second. */
+const Uint64 SGB_NANOSECONDS_PER_SECOND = 1000000000;
+
+/*! \brief Defines how many nanoseconds there are in a millisecond (a SDL "tick"). */
+const Uint64 SGB_NANOSECONDS_PER_TICK = 1000000;
+
+/*! \brief Internal class. A monotonic, high resolution clock based on
+* `SDL_GetPerformanceCounter()`.
+*
+* Unlike `SDL_GetTicks()`, the values are not quantized to whole
+* milliseconds and, being 64 bits wide, will not wrap around in any
+* realistic running time.
+*/
+class SGB_Clock
+{
+public:
+	/*! \brief Gets the current value of the clock, in nanoseconds.
+	*
+	* The starting point is arbitrary, so only differences between two
+	* calls are meaningful.
+	*/
+	static Uint64 GetNanoseconds();
+};
@@ -10,9 +10,28 @@
 #include "SGB_Screen.h"
 #include "SGB_DisplayLoadingManager.h"
 #include "SGB_DisplayTimingManager.h"
+#include "SGB_DisplayProfiler.h"
+#include "SGB_JobSystem.h"
+#include "SGB_DrawBatch.h"
+#include "SGB_ResourceManager.h"
+#include "SGB_Queue.h"
 
 class SGB_Screen;
 
+/*! \brief Internal struct. A surface waiting to be turned into a
+ * texture on the main thread. */
+struct SGB_TextureUpload
+{
+	/*! \brief The SGB_Screen that queued the upload. */
+	SGB_Screen* owner;
+
+	/*! \brief The surface to be uploaded and freed. */
+	SDL_Surface* surface;
+
+	/*! \brief Where the created texture is stored. */
+	SDL_Texture** texture;
+};
+
 //TODO: Try to insert the code from the example application on the documentation
 
 /*! \brief A class to initialize and manage SDL_Window, SDL_Renderer
@@ -60,6 +79,9 @@ public:
 	* Call regularly on your main loop in order to keep the current
 	* SGB_Screen updated and check for any loading that can be
 	* happening at the moment.
+	*
+	* When `SGB_DisplayInitInfo::PaceFrames` is set, this method also
+	* waits until the next frame is due before returning.
 	*/
 	void Update();
 
@@ -83,9 +105,43 @@ public:
 	*
 	* If there's no loading screen, a "blank" display will
 	* shown, plus anything rendered by the `BeginDraw()` and `EndDraw()`
+	*
+	* If \p screen was given to `PreloadScreen()`, no loading screen is
+	* shown: the current SGB_Screen keeps running until \p screen is
+	* loaded and then they are switched on the next loop cycle, with
+	* the previous SGB_Screen being unloaded on the background.
+	*
+	* If a SGB_Screen is still loading, the latest call wins: the
+	* running load is cancelled (see SGB_Screen::IsLoadCancelled()),
+	* unloaded and deleted, and \p screen starts loading as soon as
+	* it returns. A request that did not start loading yet is simply
+	* replaced and deleted.
 	*/
 	void SetScreen(SGB_Screen* screen);
 
+	/*! \brief Starts loading a SGB_Screen on the background, while
+	 * the current SGB_Screen keeps running.
+	*
+	*\param screen The SGB_Screen to be loaded, that will be deleted by
+	* the SGB_Display.
+	*
+	* The SGB_Screen::LoadScreen() of \p screen runs on the loading
+	* thread, without any loading screen attached (so its
+	* `PushLoadingStatus()` calls are ignored). Pass the same instance
+	* to `SetScreen()` later to switch to it without waiting.
+	*/
+	void PreloadScreen(SGB_Screen* screen);
+
+	/*! \brief Checks if a SGB_Screen is kept loaded on the screen cache.
+	*
+	*\param name The name returned by SGB_Screen::GetScreenName().
+	*
+	* When it returns <b>true</b>, a `SetScreen()` with a new instance
+	* of that screen reuses the cached one (deleting the new instance)
+	* and skips loading. See `SGB_DisplayInitInfo::ScreenCacheBudget`.
+	*/
+	bool IsScreenCached(const char* name);
+
 	/*! \brief Set the loading screen to be used during regular
 	 * SGB_Screen's.
 	*
@@ -115,7 +171,8 @@ public:
 
 	/*! \brief Gets the instance of SDL_Window created during `Init()`.
 	*
-	* \returns The SDL_Window instance created by `Init()`.
+	* \returns The SDL_Window instance created by `Init()`, or NULL
+	* when running with `SGB_DisplayInitInfo::Headless`.
 	*/
 	SDL_Window* GetWindow();
 
@@ -125,6 +182,121 @@ public:
 	*/
 	SDL_Renderer* GetRenderer();
 
+	/*! \brief Gets the offscreen surface rendered to when running
+	 * with `SGB_DisplayInitInfo::Headless`.
+	*
+	* \returns The surface holding the rendered frames, or NULL when
+	* rendering to a window.
+	*/
+	SDL_Surface* GetFramebuffer();
+
+	/*! \brief Changes where the SGB_Display reads the time from.
+	*
+	* \param timeSource The new time source, which will be deleted by the
+	* SGB_Display. If NULL, the real time is used.
+	*
+	* Must be called before `Init()` starts the global timer (at the
+	* latest on `AfterInit()`). With a `SGB_ManualTimeSource`, each
+	* `Update()` sees the same, reproducible, `DeltaTicks` and
+	* `DeltaSeconds` and the loop runs without waiting between frames.
+	*/
+	void SetTimeSource(SGB_TimeSource* timeSource);
+
+	/*! \brief Gets the job system owned by the SGB_Display.
+	*
+	* \returns The SGB_JobSystem started by `Init()`, with
+	* `SGB_DisplayInitInfo::JobWorkerCount` worker threads.
+	*
+	* Screens can use it to load their resources in parallel on
+	* `SGB_Screen::LoadScreen()`.
+	*/
+	SGB_JobSystem* GetJobSystem();
+
+	/*! \brief Gets the resource manager owned by the SGB_Display.
+	*
+	* \returns The SGB_ResourceManager shared by every SGB_Screen, to
+	* keep common resources loaded across transitions.
+	*/
+	SGB_ResourceManager* GetResourceManager();
+
+	/*! \brief Queues a surface to be turned into a texture on the main
+	 * thread.
+	*
+	* \param owner The SGB_Screen to be told when its textures are ready.
+	* \param surface The surface to be uploaded and then freed.
+	* \param[out] texture Where the created texture will be stored.
+	*
+	* Use SGB_Screen::QueueTextureUpload() instead, which also keeps
+	* track of the pending uploads of the SGB_Screen. Can be called
+	* from any thread.
+	*/
+	void QueueTextureUpload(SGB_Screen* owner, SDL_Surface* surface,
+		SDL_Texture** texture);
+
+	/*! \brief Frees the surfaces an SGB_Screen queued to be uploaded,
+	 * without creating their textures.
+	*
+	* \param owner The SGB_Screen about to be unloaded.
+	*
+	* This method is not intended to be called manually, as it is
+	* executed on the main thread when an SGB_Screen is queued to be
+	* unloaded, so the loader thread never waits for its uploads.
+	*/
+	void DiscardTextureUploads(SGB_Screen* owner);
+
+	/*! \brief Reads back the pixels of the frame being rendered.
+	*
+	* \param[out] pixels The buffer to be filled, at least
+	* `pitch * height` bytes long.
+	* \param pitch The length of a row of `pixels`, in bytes.
+	* \param format The SDL_PixelFormatEnum wanted for `pixels`.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise.
+	*
+	* Works with both window and headless displays. As the contents of
+	* a window are undefined after being presented, call it from
+	* `BeforePresent()`. A wrapper for `SDL_RenderReadPixels()`.
+	*/
+	int ReadPixels(void* pixels, int pitch,
+		Uint32 format = SDL_PIXELFORMAT_ARGB8888);
+
+	/*! \brief Gets the batch the SGB_Screen rectangle helpers record
+	 * into.
+	*
+	* \returns The SGB_DrawBatch owned by the SGB_Display, or NULL if
+	* `SGB_DisplayInitInfo::BatchDraws` is not set.
+	*/
+	SGB_DrawBatch* GetDrawBatch();
+
+	/*! \brief Marks the whole frame to be rendered again.
+	*
+	* Only needed with `SGB_DisplayInitInfo::RenderOnChange`, where
+	* frames are not rendered until something is invalidated.
+	* Invalidating while drawing applies to the next frame.
+	*
+	* Must be called on the main thread. A LoadScreen() running on the
+	* loader thread should report its progress instead, invalidating
+	* when the status is pulled.
+	*/
+	void Invalidate();
+
+	/*! \brief Marks an area of the frame to be rendered again.
+	*
+	* \param rect The area that changed. Areas invalidated before the
+	* next frame are merged.
+	*
+	* The previous frame is only kept by the headless framebuffer, where
+	* the clear and draw pass is clipped to the area. As SDL does not
+	* keep the contents of a window after `SDL_RenderPresent()`, a
+	* window frame is rendered whole. Must be called on the main thread.
+	*/
+	void Invalidate(SDL_Rect rect);
+
+	/*! \brief Checks if anything was invalidated since the last
+	 * rendered frame. */
+	bool IsDirty();
+
 	/*! \brief Set the current render color to the
 	 * `SGB_DisplayInitInfo::RendererDefaultDrawColor` defined on `Init()` */
 	void ResetDrawColor();
@@ -132,15 +304,54 @@ public:
 	/*! \brief Set the current render color to the one informed.
 	*
 	*\param color The SDL_Color to be used as current render color
+	*
+	* Nothing is sent to the SDL_Renderer if the color is already set.
 	*/
 	void SetDrawColor(SDL_Color color);
 
 	/*! \brief Gets current render color.
 	*
-	* \returns The current render color.
+	* \returns The current render color, read from the shadow state
+	* kept by the SGB_Display instead of the SDL_Renderer.
 	*/
 	SDL_Color GetDrawColor();
 
+	/*! \brief Sets the blend mode used by the drawing operations.
+	*
+	* \param blendMode The SDL_BlendMode to be used.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise. Nothing is sent to the SDL_Renderer
+	* if the blend mode is already set.
+	*/
+	int SetBlendMode(SDL_BlendMode blendMode);
+
+	/*! \brief Gets the blend mode used by the drawing operations. */
+	SDL_BlendMode GetBlendMode();
+
+	/*! \brief Sets the texture rendered to.
+	*
+	* \param target A texture created with SDL_TEXTUREACCESS_TARGET,
+	* or NULL to render to the window (or framebuffer).
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise. Nothing is sent to the SDL_Renderer
+	* if the target is already set.
+	*/
+	int SetRenderTarget(SDL_Texture* target);
+
+	/*! \brief Gets the texture rendered to, or NULL for the window. */
+	SDL_Texture* GetRenderTarget();
+
+	/*! \brief Reads the draw color, blend mode and render target back
+	 * from the SDL_Renderer.
+	*
+	* The SGB_Display keeps a copy of that state to skip redundant SDL
+	* calls, so call it after changing any of them directly through the
+	* SDL_Renderer (see SGB_RenderStateGuard to change them temporarily).
+	*/
+	void SyncRenderState();
+
 	/*! \brief Gets a copy of the initialization data provided by
 	 * `GetInitInfo()`.*/
 	SGB_DisplayInitInfo GetDisplayInitInfo();
@@ -148,6 +359,45 @@ public:
 	/*! \brief Gets a copy of the current loop cycle stats.*/
 	SGB_DisplayLoopStats GetLoopStats();
 
+	/*! \brief Gets information about the SGB_Screen transitions done
+	 * so far, like the memory used while a deferred unload overlapped
+	 * two screens.
+	*
+	* \returns The SGB_DisplayLoadingStats with the current values.
+	*/
+	SGB_DisplayLoadingStats GetLoadingStats();
+
+	/*! \brief Gets the progress tracker of the SGB_Screen being
+	 * loaded, to register and report its tasks or show the progress.
+	*
+	* \returns The SGB_LoadingProgress owned by the SGB_Display.
+	*/
+	SGB_LoadingProgress* GetLoadingProgress();
+
+	/*! \brief Gets the frame time distribution of the last rendered
+	 * frames.
+	*
+	* The stats are calculated on each call, so avoid calling it more
+	* than once per loop cycle.
+	*/
+	SGB_DisplayFrameStats GetFrameStats();
+
+	/*! \brief Gets how long each phase of the last finished loop
+	 * cycle took.
+	*
+	* Only filled when `SGB_DisplayInitInfo::EnableProfiler` is set.
+	*/
+	SGB_FrameProfile GetFrameProfile();
+
+	/*! \brief Gets the phase timings of the last
+	 * `SGB_PROFILER_HISTORY_SIZE` loop cycles, oldest first.
+	*
+	* \param[out] history Filled with the stored loop cycles.
+	*
+	* Only filled when `SGB_DisplayInitInfo::EnableProfiler` is set.
+	*/
+	void GetFrameProfileHistory(std::vector<SGB_FrameProfile>& history);
+
 protected:
 
 	/*! \brief Execute actions before `Init()` is run.
@@ -195,12 +445,33 @@ protected:
 	*/
 	virtual void EndDraw() {};
 
+	/*! \brief Allows to access a frame after everything was
+	 * rendered, right before it is presented.
+	*
+	* Use it with `ReadPixels()` to capture frames, for example to
+	* compare or save the output of a headless display.
+	*/
+	virtual void BeforePresent() {};
+
 	/*! \brief Holds the SDL_Window instance created by `Init()` */
 	SDL_Window* _window;
 
 	/*! \brief Holds the SDL_Renderer instance created by `Init()` */
 	SDL_Renderer* _renderer;
 
+	/*! \brief Holds the offscreen surface created by `Init()` when
+	 * running with `SGB_DisplayInitInfo::Headless` (NULL otherwise) */
+	SDL_Surface* _framebuffer;
+
+	/*! \brief Holds the last draw color set on the SDL_Renderer. */
+	SDL_Color _drawColor;
+
+	/*! \brief Holds the last blend mode set on the SDL_Renderer. */
+	SDL_BlendMode _blendMode;
+
+	/*! \brief Holds the last render target set on the SDL_Renderer. */
+	SDL_Texture* _renderTarget;
+
 	/*! \brief Holds the initialization info provided by
 	* `GetInitInfo()` and used on `Init()` for later use.
 	*
@@ -221,15 +492,43 @@ protected:
 
 private:
 
+	/*! \brief Creates the SDL_Window and its SDL_Renderer.
+	 *
+	 * \returns <b>SGB_SUCCESS</b> if there's no problem,
+	 * <b>SGB_FAIL</b> otherwise.
+	 */
+	int CreateWindowRenderer();
+
+	/*! \brief Creates an offscreen SDL_Surface and a software
+	 * SDL_Renderer drawing to it, without any window.
+	 *
+	 * \returns <b>SGB_SUCCESS</b> if there's no problem,
+	 * <b>SGB_FAIL</b> otherwise.
+	 */
+	int CreateHeadlessRenderer();
+
 	/*! \brief Update cycle status and the current SGB_Screen.
 	 *
 	 * \param screen The current SGB_Screen.
 	 *
 	 * Here the calculations about the current loop cycle are done, as
 	 * well the call for the current SGB_Screen's
-	 * `SGB_Screen::Update()`.
+	 * `SGB_Screen::Update()` (once, or once per accumulated step when
+	 * `SGB_DisplayInitInfo::FixedTimestep` is set).
 	 */
 	void UpdateScreen(SGB_Screen* screen);
+
+	/*! \brief Reads all pending SDL events and hands them to the
+	 * current SGB_Screen.
+	 *
+	 * \param screen The current SGB_Screen.
+	 *
+	 * SDL's queue is drained in batches of `SGB_EVENT_BATCH_SIZE`
+	 * with `SDL_PeepEvents()`. A `SDL_QUIT` event calls
+	 * `StopRunning()`, and the whole batch is passed to the current
+	 * SGB_Screen's `SGB_Screen::HandleEvents()`.
+	 */
+	void HandleEvents(SGB_Screen* screen);
 	
 	/*! \brief Render the current SGB_Screen.
 	 *
@@ -238,12 +537,24 @@ private:
 	 * Here the drawing calls are done: starting with
 	 * `BeginDraw()`, the current SGB_Screen's
 	 * `SGB_Screen::Draw()` and then `EndDraw()`.
+	 *
+	 * \returns <b>true</b> if a frame was rendered and presented.
 	 */
-	void RenderScreen(SGB_Screen* screen);
+	bool RenderScreen(SGB_Screen* screen);
+
+	/*! \brief Creates the textures queued by the screens, until the
+	 * queue is empty or `SGB_DisplayInitInfo::TextureUploadBudget`
+	 * runs out.
+	 */
+	void UploadTextures();
 
 	/*! \brief Fills the underlying renderer with the defined
-	 * background color. */
-	void Clear();
+	 * background color.
+	 *
+	 * \param region The area to be filled, or NULL for the whole
+	 * target.
+	 */
+	void Clear(const SDL_Rect* region = NULL);
 
 	/*! \brief Tries to check if the application is running on a device
 	 * operation on batteries.
@@ -259,6 +570,18 @@ private:
 	 */
 	bool _isRunning;
 
+	/*! \brief Runs jobs in parallel for the SGB_Display and its
+	* SGB_Screen's. Declared before `_loadingManager`, so it outlives
+	* the screens.
+	*/
+	SGB_JobSystem _jobSystem;
+
+	/*! \brief Shares resources between the SGB_Screen's. Declared
+	* before `_loadingManager`, so the screens can release their
+	* resources when deleted.
+	*/
+	SGB_ResourceManager _resourceManager;
+
 	/*! \brief Hold data related to the loading process between
 	* SGB_Screen's.
 	*/
@@ -266,5 +589,31 @@ private:
 
 	/*! \brief Holds data related to loop cycle information. */
 	SGB_DisplayTimingManager _timingManager;
+
+	/*! \brief Measures the time spent on each loop cycle phase. */
+	SGB_DisplayProfiler _profiler;
+
+	/*! \brief Holds the events read on the current loop cycle. */
+	std::vector<SDL_Event> _events;
+
+	/*! \brief Holds the surfaces waiting to be turned into textures. */
+	SGB_Queue<SGB_TextureUpload> _textureUploads;
+
+	/*! \brief Holds the rectangles recorded on the current frame, when
+	 * `SGB_DisplayInitInfo::BatchDraws` is set. */
+	SGB_DrawBatch _drawBatch;
+
+	/*! \brief Indicates that something was invalidated since the last
+	 * rendered frame. Only used on the main thread, as the fields below. */
+	bool _dirty;
+
+	/*! \brief Indicates that only `_dirtyRect` was invalidated. */
+	bool _partiallyDirty;
+
+	/*! \brief Holds the merged areas given to `Invalidate(SDL_Rect)`. */
+	SDL_Rect _dirtyRect;
+
+	/*! \brief Holds the SGB_Screen of the last rendered frame. */
+	SGB_Screen* _renderedScreen;
 };
 
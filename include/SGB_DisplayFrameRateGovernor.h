@@ -0,0 +1,83 @@
+#pragma once
+
+#include "SGB_types.h"
+
+/*! \brief Internal class. Adjusts the frame rate of a `SGB_Display`
+* at runtime.
+*
+* Periodically checks the power state with `SDL_GetPowerInfo()`, so
+* unplugging (or plugging) a device changes the frame rate settings on
+* the fly, and lowers the target frame rate when too many frames miss
+* their deadline, raising it back when they stop missing.
+*
+* Only active when `SGB_DisplayInitInfo::AdaptiveFrameRate` is set.
+*/
+class SGB_DisplayFrameRateGovernor
+{
+public:
+	SGB_DisplayFrameRateGovernor();
+
+	/*! \brief Prepare the governor
+	*
+	* \param info The `SGB_DisplayInitInfo` generated by the parent `SGB_Display`.
+	* \param now The current time, in nanoseconds.
+	*/
+	void Setup(SGB_DisplayInitInfo info, Uint64 now);
+
+	/*! \brief Registers a rendered frame and how long it took since
+	 * the previous one.
+	*
+	* \param frameTime The frame duration, in nanoseconds.
+	*/
+	void RecordFrame(Uint64 frameTime);
+
+	/*! \brief Re-evaluates the frame rate settings, if it is time to.
+	*
+	* \param now The current time, in nanoseconds.
+	*
+	* \returns <b>true</b> if the effective frame rate or the unlocked
+	* state changed.
+	*/
+	bool Update(Uint64 now);
+
+	/*! \brief Gets the frame rate currently being targeted. */
+	Uint32 GetEffectiveFrameRate();
+
+	/*! \brief Checks if the frame rate is currently unlocked. */
+	bool IsFrameRateUnlocked();
+
+	/*! \brief Checks if the last power check detected battery operation. */
+	bool IsRunningOnBattery();
+
+private:
+	/*! \brief Reads the power state and applies the battery settings. */
+	void CheckPowerState();
+
+	/*! \brief Compares the deadlines missed on the last window with
+	 * the thresholds, stepping the frame rate down or up. */
+	void EvaluateWindow();
+
+	SGB_DisplayInitInfo _initInfo;
+
+	//Indicates if the governor is doing anything at all
+	bool _enabled;
+
+	bool _onBattery;
+	bool _unlocked;
+
+	//Highest frame rate allowed by the current power state
+	Uint32 _frameRateCap;
+
+	Uint32 _effectiveFrameRate;
+
+	Uint64 _nextPowerCheck;
+	Uint64 _windowStart;
+
+	//Frames rendered and deadlines missed on the current window
+	Uint32 _windowFrames;
+	Uint32 _windowMisses;
+
+	//How many windows in a row were above or below the thresholds
+	Uint32 _badWindows;
+	Uint32 _goodWindows;
+};
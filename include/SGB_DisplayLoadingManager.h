@@ -1,12 +1,31 @@
 #pragma once
 
 #include <atomic>
+#include <vector>
 
 #include "SGB_SDL.h"
+#include "SGB_Queue.h"
+#include "SGB_LoadingProgress.h"
+#include "SGB_types.h"
 
 class SGB_Display;
 class SGB_Screen;
 
+/*! \brief Internal struct. A request for the loader worker thread. */
+struct SGB_LoadingJob
+{
+	/*! \brief The SGB_Screen to be unloaded and deleted, or NULL.
+	 * When it is also `screenToBeLoaded`, it is only unloaded, to be
+	 * loaded again. */
+	SGB_Screen* screenToBeUnloaded;
+
+	/*! \brief The SGB_Screen to be loaded, or NULL. */
+	SGB_Screen* screenToBeLoaded;
+
+	/*! \brief Signals the worker thread to finish. */
+	bool stop;
+};
+
 /*! \brief Internal class. Handles the transtion process between `SGB_Screen`'s
 * for a `SGB_Display`.
 */
@@ -22,9 +41,47 @@ public:
 	*/
 	void SetOwner(SGB_Display* owner);
 
-	/*! \brief Sets the next `SGB_Screen` to be loaded, starting the loading process.*/
+	/*! \brief Prepare the loading manager
+	*
+	* \param info The `SGB_DisplayInitInfo` generated by the parent `SGB_Display`.
+	*/
+	void Setup(SGB_DisplayInitInfo info);
+
+	/*! \brief Starts the loader worker thread, that waits for loading
+	 * jobs for the lifetime of the instance.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise.
+	*/
+	int Start();
+
+	/*! \brief Lets the loader worker thread finish any job in progress
+	 * and waits for it to end.
+	*/
+	void Stop();
+
+	/*! \brief Stops the loader worker thread, then unloads and deletes
+	 * every SGB_Screen still held.
+	*
+	* Called by the owner `SGB_Display` before destroying its renderer,
+	* as the screens may release textures of it. Safe to call more than once.
+	*/
+	void Shutdown();
+
+	/*! \brief Sets the next `SGB_Screen` to be loaded, starting the loading process.
+	*
+	* The latest request wins: a request not started yet is replaced
+	* (and deleted) and a running load is cancelled, with the new
+	* request starting once the cancelled `SGB_Screen::LoadScreen()`
+	* returns.
+	*/
 	void SetScreen(SGB_Screen* screen);
 
+	/*! \brief Starts loading a `SGB_Screen` on the loader worker thread,
+	 * without starting a transition to it.
+	*/
+	void PreloadScreen(SGB_Screen* screen);
+
 	/*! \brief Sets the `SGB_LoadingScreen` to be used between `SGB_Screen` transitions.
 	*
 	* If a previous `SGB_LoadingScreen` was set, it will be unloaded and freed.
@@ -37,6 +94,19 @@ public:
 	/*! \brief Gets the screen to be used by the `SGB_Display` owner. */
 	SGB_Screen* GetCurrentScreen();
 
+	/*! \brief Gets information about the transitions done so far. */
+	SGB_DisplayLoadingStats GetLoadingStats();
+
+	/*! \brief Finds a `SGB_Screen` on the screen cache by its name.
+	*
+	* \returns The cached instance, or NULL if there is none.
+	*/
+	SGB_Screen* FindCachedScreen(const char* name);
+
+	/*! \brief Gets the progress tracker of the load running on the
+	 * loader worker thread. */
+	SGB_LoadingProgress* GetLoadingProgress();
+
 private:
 	/*! \brief Start preparing the transition to a new `SGB_Screen`.
 	*
@@ -45,20 +115,25 @@ private:
 	*/
 	void PrepareToLoad();
 
-	/*! \brief Starts a thread calling `ExecuteLoadingProcess()`.
-	*
-	* This thread call passes the current instance to the satic method
-	* being called.
+	/*! \brief Sends the prepared transition to the loader worker
+	* thread, that will call `ExecuteLoadingProcess()`.
 	*/
 	void StartLoadingProcess();
 
+	/*! \brief Entry point of the loader worker thread.
+	*
+	* Waits for jobs on _loadingJobs and executes them, one at a time,
+	* until a stop job is received.
+	*/
+	static int ExecuteLoadingWorker(void* data);
+
 	/*! \brief Manages the loading steps to load and unload SGB_Screen`s
 	* as necessary.
 	*
 	* This method unloads the previous screen, loads the next one and
-	* flags _finishedLoadingScreen to <b>true</b> when finished.
+	* flags it as loaded when finished.
 	*/
-	static int ExecuteLoadingProcess(void* data);
+	void ExecuteLoadingProcess(SGB_LoadingJob job);
 
 	/*! \brief Puts the newly loaded SGB_Screen as the current screen.
 	*
@@ -67,6 +142,65 @@ private:
 	*/
 	void FinishLoadingProcess();
 
+	/*! \brief Checks if a `SGB_Screen` was given to `PreloadScreen()`
+	 * and was not shown yet.
+	*/
+	bool IsPreloaded(SGB_Screen* screen);
+
+	/*! \brief Checks if a `SGB_Screen` finished loading and all the
+	 * textures it queued were created.
+	*/
+	bool IsReady(SGB_Screen* screen);
+
+	/*! \brief Switches to a preloaded `SGB_Screen` as soon as it is
+	* loaded, without a loading screen, queueing the previous one to be
+	* unloaded on the loader worker thread.
+	*/
+	void SwitchToPreloadedScreen();
+
+	/*! \brief Replaces the current `SGB_Screen` with an already loaded
+	* one, caching or queueing the previous one to be unloaded.
+	*/
+	void ShowLoadedScreen(SGB_Screen* screen);
+
+	/*! \brief Keeps an outgoing `SGB_Screen` loaded on the screen
+	* cache, evicting the least recently used ones over the budget.
+	*
+	* \returns <b>true</b> if the cache took ownership of the screen.
+	*/
+	bool CacheScreen(SGB_Screen* screen);
+
+	/*! \brief Queues an evicted `SGB_Screen` to be unloaded and
+	 * deleted on the loader worker thread.
+	*/
+	void QueueUnload(SGB_Screen* screen);
+
+	/*! \brief Deletes a requested `SGB_Screen` replaced by a newer
+	 * request before being loaded, unless it is preloaded.
+	*/
+	void DiscardRequest(SGB_Screen* screen);
+
+	/*! \brief After a cancelled load returns, queues it to be unloaded
+	* and starts loading the latest requested `SGB_Screen`, keeping the
+	* loading screen.
+	*/
+	void LoadPendingScreen();
+
+	/*! \brief Takes the cached instance of a requested `SGB_Screen` out
+	 * of the screen cache, deleting the requested instance.
+	*/
+	SGB_Screen* TakeCachedScreen(SGB_Screen* requested);
+
+	/*! \brief Checks if the previous `SGB_Screen` can stay loaded
+	 * until the next one is shown.
+	*/
+	bool CanDeferUnload(SGB_Screen* previous, SGB_Screen* next);
+
+	/*! \brief Queues a `SGB_Screen` that was replaced by a loaded one
+	 * to be unloaded and deleted on the loader worker thread.
+	*/
+	void UnloadReplacedScreen(SGB_Screen* previous, SGB_Screen* next);
+
 	SGB_Display* _owner;
 
 	//Stores the current SGB_Screen beign rendered at the moment
@@ -85,10 +219,30 @@ private:
 	//Indicates if a loading routine is in progress.
 	bool _loadingNextScreen;
 
-	//Indicates if the loading process finished.
-	std::atomic<bool> _finishedLoadingScreen;
+	//Holds the latest SGB_Screen requested while another one was loading,
+	//to be loaded once the cancelled load returns
+	SGB_Screen* _pendingScreen;
 
-	//Holds the thread being used to execute the loading process
-	SDL_Thread* _loadingThread;
+	//Holds the loader worker thread, running from Start() to Stop()
+	SDL_Thread* _loadingThread;
+
+	SGB_DisplayInitInfo _initInfo;
+
+	SGB_DisplayLoadingStats _loadingStats;
+
+	//Holds the previous SGB_Screen until the next one is shown, when unloading is deferred
+	SGB_Screen* _screenToBeUnloadedLater;
+
+	//Outgoing screens kept loaded, from the most to the least recently used
+	std::vector<SGB_Screen*> _screenCache;
+
+	//Screens given to PreloadScreen() that were not shown yet
+	std::vector<SGB_Screen*> _preloadedScreens;
+
+	//Jobs waiting for the loader worker thread
+	SGB_Queue<SGB_LoadingJob> _loadingJobs;
+
+	//Tracks the load running on the worker thread and the recorded load durations
+	SGB_LoadingProgress _progress;
 
 };
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+
+#include "SGB_types.h"
+#include "SGB_Clock.h"
+#include "SGB_RingBuffer.h"
+#include "SGB_Tracer.h"
+
+/*! \brief Internal class. Measures how long each phase of a
+* `SGB_Display` loop cycle takes.
+*
+* Every method returns right away when neither the profiler nor the
+* `SGB_Tracer` are enabled, and compiles to nothing when
+* `SGB_ENABLE_PROFILER` is 0.
+*/
+class SGB_DisplayProfiler
+{
+public:
+	SGB_DisplayProfiler();
+
+	/*! \brief Prepare the profiler
+	*
+	* \param info The `SGB_DisplayInitInfo` generated by the parent `SGB_Display`.
+	* \param startTime The clock value when the `SGB_Display` started.
+	*/
+	void Setup(SGB_DisplayInitInfo info, Uint64 startTime);
+
+	/*! \brief Starts measuring a new loop cycle.
+	*
+	* The phases of the loop cycle are also recorded as trace events
+	* if `SGB_Tracer` is active when it starts.
+	*/
+	void BeginFrame()
+	{
+#if SGB_ENABLE_PROFILER
+		_tracing = SGB_Tracer::IsActive();
+		_active = _enabled || _tracing;
+
+		if (_active) StartFrame();
+#endif
+	}
+
+	/*! \brief Finishes the current loop cycle, storing it on the history. */
+	void EndFrame()
+	{
+#if SGB_ENABLE_PROFILER
+		if (_active) FinishFrame();
+#endif
+	}
+
+	/*! \brief Starts measuring a phase of the current loop cycle. */
+	void BeginPhase(SGB_FramePhase phase)
+	{
+#if SGB_ENABLE_PROFILER
+		if (_active) _phaseStart[phase] = SGB_Clock::GetNanoseconds();
+#else
+		(void)phase;
+#endif
+	}
+
+	/*! \brief Finishes measuring a phase of the current loop cycle.
+	*
+	* A phase can happen more than once on the same loop cycle, the
+	* times are added up.
+	*/
+	void EndPhase(SGB_FramePhase phase)
+	{
+#if SGB_ENABLE_PROFILER
+		if (_active) FinishPhase(phase);
+#else
+		(void)phase;
+#endif
+	}
+
+	/*! \brief Gets the last finished loop cycle measurements. */
+	SGB_FrameProfile GetLastFrame();
+
+	/*! \brief Copies the stored loop cycle measurements, oldest first. */
+	void GetHistory(std::vector<SGB_FrameProfile>& history);
+
+private:
+	void StartFrame();
+	void FinishPhase(SGB_FramePhase phase);
+	void FinishFrame();
+
+	//Indicates if the measurements are being stored on the history
+	bool _enabled;
+
+	//Indicates if the current loop cycle is being sent to SGB_Tracer
+	bool _tracing;
+
+	//Indicates if the current loop cycle is being measured at all
+	bool _active;
+
+	//The clock value when the SGB_Display started
+	Uint64 _startTime;
+
+	//The clock value when the current loop cycle started
+	Uint64 _frameStart;
+
+	//The clock value when each phase of the current loop cycle started
+	Uint64 _phaseStart[SGB_FRAME_PHASE_COUNT];
+
+	//The loop cycle being measured
+	SGB_FrameProfile _currentFrame;
+
+	//The last SGB_PROFILER_HISTORY_SIZE measured loop cycles
+	SGB_RingBuffer<SGB_FrameProfile> _history;
+};
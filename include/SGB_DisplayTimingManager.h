@@ -3,17 +3,30 @@
 #include <vector>
 
 #include "SGB_types.h"
+#include "SGB_Clock.h"
+#include "SGB_RingBuffer.h"
+#include "SGB_DisplayFrameRateGovernor.h"
+#include "SGB_TimeSource.h"
 
 /*! \brief Internal class. Handles timing managemente for a `SGB_Display`. */
 class SGB_DisplayTimingManager
 {
 public:
+	SGB_DisplayTimingManager();
+	~SGB_DisplayTimingManager();
+
 	/*! \brief Prepare the timing manager
 	*
 	* \param info The `SGB_DisplayInitInfo` generated by the parent `SGB_Display`.
 	*/
 	void Setup(SGB_DisplayInitInfo info);
 
+	/*! \brief Replaces the source of the time, taking ownership of it.
+	*
+	* \param timeSource The new time source. If NULL, the real time is used.
+	*/
+	void SetTimeSource(SGB_TimeSource* timeSource);
+
 	/*! \brief Starts a `SGB_Timer` to keep track of the total running time */
 	Uint32 StartGlobalTimer();
 	
@@ -23,16 +36,74 @@ public:
 	/*! \brief Gets the most recent calculated average framerate. */
 	Uint32 CalculateAverageFPS();
 
+	/*! \brief Calculates the frame time distribution of the last
+	 * rendered frames.
+	*
+	* The frame history is only sorted here, so the cost is paid when
+	* the stats are requested, not on every frame.
+	*/
+	SGB_DisplayFrameStats CalculateFrameStats();
+
 	/*! \brief Gets the total ticks since the global timer started.*/
 	Uint32 GetGlobalTicks();
 
 	/*! \brief Gets the total ticks since the last loop cycle.*/
 	Uint32 GetDeltaTicks();
 
+	/*! \brief Gets the total nanoseconds since the global timer started.*/
+	Uint64 GetGlobalNanoseconds();
+
+	/*! \brief Gets the total nanoseconds since the last loop cycle.*/
+	Uint64 GetDeltaNanoseconds();
+
 	/*! \brief Checks if it is time to render on the screen,
-	 * based on the current time and settings. */
+	 * based on the current time and settings.
+	*
+	* A <b>true</b> result consumes the frame interval, whether the
+	* frame is rendered or not. Call `RecordRenderedFrame()` when it is.
+	*/
 	bool CanRender();
 
+	/*! \brief Counts the frame allowed by the last `CanRender()` as
+	 * rendered, on the frame rate, the frame time stats and the
+	 * adaptive frame rate governor.
+	*/
+	void RecordRenderedFrame();
+
+	/*! \brief Blocks until the next frame is due to be rendered.
+	*
+	* Sleeps for most of the remaining time and spins for the rest,
+	* learning how much the OS oversleeps to decide when to stop
+	* sleeping. Returns immediately if the frame rate is unlocked or
+	* `SGB_DisplayInitInfo::PaceFrames` is not set, unless forced.
+	*
+	* \param force Waits regardless of the settings, e.g. when no frame
+	* was rendered and nothing else would slow the loop down.
+	*/
+	void WaitForNextFrame(bool force = false);
+
+	/*! \brief Adds the last loop cycle time to the fixed step accumulator.
+	*
+	* \returns How many fixed steps must be run on this loop cycle,
+	* capped at `SGB_DisplayInitInfo::MaxUpdateStepsPerFrame`.
+	*/
+	Uint32 ConsumeFixedSteps();
+
+	/*! \brief Gets the duration of a single fixed step, in ticks. */
+	Uint32 GetFixedStepTicks();
+
+	/*! \brief Gets the duration of a single fixed step, in nanoseconds. */
+	Uint64 GetFixedStepNanoseconds();
+
+	/*! \brief Gets how much of the next fixed step is already accumulated (0.0 to 1.0). */
+	float GetInterpolationAlpha();
+
+	/*! \brief Gets the frame rate currently being targeted. */
+	Uint32 GetEffectiveFrameRate();
+
+	/*! \brief Checks if the frame rate is currently unlocked. */
+	bool IsFrameRateUnlocked();
+
 private:
 	//The frames per second timer
 	//SGB_Timer fpsTimer;
@@ -47,20 +118,58 @@ private:
 	int countedFrames;
 
 	//Stores when the last FPS sampling happened
-	Uint32 _lastFPSReset;
+	Uint64 _lastFPSReset;
 
 	//Stores how much time is expected to pass between frame rendering and calculation
-	Uint32 _frameInterval;
+	Uint64 _frameInterval;
 
 	//Store the last (_initInfo.FrameRateSamplesPerSecond) framecounts between FPS samplings
-	std::vector<Uint32> _fpsQueue;
+	SGB_RingBuffer<Uint32> _fpsQueue;
+
+	//Running sum of the values on _fpsQueue
+	Uint32 _fpsQueueSum;
+
+	//Stores the duration of the last SGB_FRAME_HISTORY_SIZE rendered frames
+	SGB_RingBuffer<Uint64> _frameTimes;
+
+	//Running sum of the values on _frameTimes
+	Uint64 _frameTimesSum;
+
+	//Stores when the last frame was due, rendered or not
+	Uint64 _lastFrameDueTime;
+
+	//Stores the time between the last two frames due, recorded by RecordRenderedFrame()
+	Uint64 _frameTime;
+
+	//Reused buffer to sort _frameTimes on CalculateFrameStats()
+	std::vector<Uint64> _sortedFrameTimes;
 
 	SGB_DisplayInitInfo _initInfo;
 
 	Uint32 _currentAverageFPS;
 
-	Uint32 _currentTime;
-	Uint32 _totalElapsed;
-	Uint32 _loopElapsed;
+	//All the time fields below are in nanoseconds, read from SGB_Clock
+	Uint64 _startTime;
+	Uint64 _currentTime;
+	Uint64 _totalElapsed;
+	Uint64 _loopElapsed;
+
+	//Stores the duration of each fixed update step
+	Uint64 _fixedStepInterval;
+
+	//Stores the time not yet consumed by fixed update steps
+	Uint64 _fixedAccumulator;
+
+	//Stores how much later than requested SDL_Delay usually returns
+	Uint64 _sleepOvershoot;
+
+	//Indicates if frames are rendered regardless of _frameInterval
+	bool _unlockFrameRate;
+
+	//Where the time is read from, owned by the timing manager
+	SGB_TimeSource* _timeSource;
+
+	//Changes _frameInterval and _unlockFrameRate at runtime
+	SGB_DisplayFrameRateGovernor _governor;
 };
 
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+
+#include "SGB_SDL.h"
+
+class SGB_Display;
+
+/*! \brief Records rectangles to be drawn and renders them grouped by
+* color, with a single SDL call per color.
+*
+* Drawing a rectangle with a given color through the SDL_Renderer
+* takes a call to set the color, one to draw and others to restore the
+* previous color. The batch only records the rectangle, and
+* `Flush()` sorts the recorded ones by color, sending each group with
+* `SDL_RenderFillRects()` or `SDL_RenderDrawRects()`.
+*
+* A SGB_Display owns one instance, used by the SGB_Screen drawing
+* helpers when `SGB_DisplayInitInfo::BatchDraws` is set, and flushed
+* after `SGB_Screen::Draw()` and after `SGB_Display::EndDraw()`.
+*
+* As the rectangles are rendered after anything drawn directly with
+* the SDL_Renderer, and the ones with different colors may be
+* reordered, call `SGB_Screen::FlushDraws()` before drawing textures
+* that must appear over them, or before overlapping rectangles with
+* different colors.
+*/
+class SGB_DrawBatch
+{
+public:
+	SGB_DrawBatch();
+
+	/*! \brief Sets the SGB_Display whose renderer the recorded
+	 * rectangles are rendered with. */
+	void SetDisplay(SGB_Display* display);
+
+	/*! \brief Records a filled rectangle.
+	*
+	* \param rect The position and size of the rectangle.
+	* \param color The color to fill it with.
+	*/
+	void FillRect(const SDL_Rect& rect, SDL_Color color);
+
+	/*! \brief Records a non-filled rectangle.
+	*
+	* \param rect The position and size of the rectangle.
+	* \param color The color to draw its outline with.
+	*/
+	void DrawRect(const SDL_Rect& rect, SDL_Color color);
+
+	/*! \brief Renders every recorded rectangle and clears the batch.
+	*
+	* The render draw color is restored afterwards.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise.
+	*/
+	int Flush();
+
+	/*! \brief Checks if there are rectangles waiting for `Flush()`. */
+	bool IsEmpty();
+
+	SGB_DrawBatch(const SGB_DrawBatch&) = delete;
+	SGB_DrawBatch& operator=(const SGB_DrawBatch&) = delete;
+
+private:
+	struct Command
+	{
+		//The RGBA color, shifted left once, plus 1 for outlines
+		Uint64 key;
+
+		//Keeps the recording order within the same key
+		Uint32 order;
+
+		SDL_Rect rect;
+	};
+
+	/*! \brief Records a rectangle with its sorting key. */
+	void Record(const SDL_Rect& rect, SDL_Color color, bool outline);
+
+	/*! \brief Renders a group of rectangles sharing the same key. */
+	int RenderGroup(SDL_Renderer* renderer, Uint64 key);
+
+	//Colors are set through it, keeping its shadowed render state right
+	SGB_Display* _display;
+
+	//Recorded on the current frame, kept allocated between frames
+	std::vector<Command> _commands;
+
+	//Rectangles of the group being rendered
+	std::vector<SDL_Rect> _rects;
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "SGB_SDL.h"
+
+/*! \brief A function submitted to a SGB_JobSystem, with its state.
+*
+* Instances are only created by `SGB_JobSystem::Submit()` and handled
+* through a SGB_JobHandle.
+*/
+class SGB_Job
+{
+public:
+	/*! \brief Checks if the job function already returned. */
+	bool IsFinished();
+
+	SGB_Job(const SGB_Job&) = delete;
+	SGB_Job& operator=(const SGB_Job&) = delete;
+
+private:
+	friend class SGB_JobSystem;
+
+	SGB_Job(std::function<void()> function);
+
+	std::function<void()> _function;
+
+	//Unfinished dependencies, plus one while the job is being submitted
+	std::atomic<Uint32> _pendingDependencies;
+
+	std::atomic<bool> _finished;
+
+	//Guards _finished changes and _dependents
+	std::mutex _mutex;
+
+	//Jobs waiting for this one to finish
+	std::vector<std::shared_ptr<SGB_Job>> _dependents;
+};
+
+/*! \brief Reference to a job submitted to a SGB_JobSystem. */
+typedef std::shared_ptr<SGB_Job> SGB_JobHandle;
+
+/*! \brief A work-stealing thread pool to run jobs in parallel.
+*
+* Each worker thread keeps its own queue of jobs, running the newest
+* ones first, and takes the oldest jobs from the other workers once its
+* queue is empty. Jobs can depend on other jobs, only starting after
+* all of them finished, so a graph of work (e.g. decode every image,
+* then build an atlas with them) can be submitted at once.
+*
+* A SGB_Display owns one instance, started on `SGB_Display::Init()`
+* with `SGB_DisplayInitInfo::JobWorkerCount` threads and available
+* through `SGB_Display::GetJobSystem()`:
+*\code{.cpp}
+*	void MyScreen::LoadScreen()
+*	{
+*		auto jobs = _display->GetJobSystem();
+*		std::vector<SGB_JobHandle> decoding;
+*
+*		for (size_t i = 0; i < _images.size(); ++i)
+*		{
+*			decoding.push_back(jobs->Submit([this, i]() {
+*				_images[i].Decode();
+*			}));
+*		}
+*
+*		auto atlas = jobs->Submit([this]() { BuildAtlas(); }, decoding);
+*
+*		jobs->Wait(atlas);
+*	}
+*\endcode
+*
+* Jobs must not call SDL_Renderer functions, as those are only safe on
+* the main thread.
+*/
+class SGB_JobSystem
+{
+public:
+	SGB_JobSystem();
+
+	/*! \brief Stops the worker threads, see `Stop()`. */
+	~SGB_JobSystem();
+
+	/*! \brief Creates the worker threads.
+	*
+	* \param workerCount How many worker threads to create. If 0, one
+	* less than the number of CPU cores is used (but at least one).
+	*
+	* \returns <b>SGB_SUCCESS</b> if the threads were created,
+	* <b>SGB_FAIL</b> otherwise (or if already started).
+	*/
+	int Start(Uint32 workerCount);
+
+	/*! \brief Runs every job still queued and waits the worker
+	 * threads to finish. */
+	void Stop();
+
+	/*! \brief Queues a function to be run by a worker thread.
+	*
+	* \param function The function to be run.
+	*
+	* \returns A handle to check or wait for the job.
+	*
+	* If the job system was not started, the function is run right
+	* away on the calling thread.
+	*/
+	SGB_JobHandle Submit(std::function<void()> function);
+
+	/*! \brief Queues a function to be run once other jobs finished.
+	*
+	* \param function The function to be run.
+	* \param dependencies The jobs that must finish before this one
+	* starts. NULL handles are ignored.
+	*
+	* \returns A handle to check or wait for the job.
+	*/
+	SGB_JobHandle Submit(std::function<void()> function,
+		const std::vector<SGB_JobHandle>& dependencies);
+
+	/*! \brief Blocks until a job is finished.
+	*
+	* \param job The job to wait for.
+	*
+	* Instead of just sleeping, the calling thread runs queued jobs
+	* while waiting, so it is safe (and efficient) to wait from inside
+	* another job.
+	*/
+	void Wait(const SGB_JobHandle& job);
+
+	/*! \brief Blocks until all the given jobs are finished.
+	*
+	* \param jobs The jobs to wait for.
+	*/
+	void Wait(const std::vector<SGB_JobHandle>& jobs);
+
+	/*! \brief Gets how many worker threads are running. */
+	Uint32 GetWorkerCount();
+
+	SGB_JobSystem(const SGB_JobSystem&) = delete;
+	SGB_JobSystem& operator=(const SGB_JobSystem&) = delete;
+
+private:
+	struct Worker
+	{
+		SGB_JobSystem* owner;
+		Uint32 index;
+		SDL_Thread* thread;
+
+		//Guards jobs, as other workers steal from it
+		std::mutex mutex;
+		std::deque<SGB_JobHandle> jobs;
+	};
+
+	/*! \brief Entry point of the worker threads */
+	static int ExecuteWorker(void* data);
+
+	/*! \brief Puts a job, with no pending dependencies, on a worker queue. */
+	void Enqueue(const SGB_JobHandle& job);
+
+	/*! \brief Takes a job from the given worker queue or, if empty,
+	 * steals one from the others, and runs it.
+	 *
+	 * \returns <b>true</b> if a job was run.
+	 */
+	bool RunNextJob(Uint32 workerIndex);
+
+	/*! \brief Runs a job and queues the dependents it released. */
+	void RunJob(const SGB_JobHandle& job);
+
+	std::vector<Worker*> _workers;
+
+	//Jobs waiting on any worker queue
+	std::atomic<Uint32> _queuedJobs;
+
+	//Threads blocked on Wait()
+	std::atomic<Uint32> _waitingThreads;
+
+	//Round robin for jobs submitted from outside the workers
+	std::atomic<Uint32> _nextWorker;
+
+	bool _running;
+
+	//Wakes idle workers and waiting threads
+	std::mutex _wakeMutex;
+	std::condition_variable _wakeCondition;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "SGB_SDL.h"
+#include "SGB_types.h"
+
+/*! \brief Tracks the progress of a `SGB_Screen::LoadScreen()` through
+* weighted tasks and estimates how long it will take.
+*
+* Instead of computing a single progress value by hand, a screen
+* registers its tasks with how much each one weighs on the whole load,
+* and reports each task progress as it goes. Reporting is a single
+* atomic store, so parallel jobs can report their own task directly,
+* without going through the SGB_LoadingQueue.
+*
+* The duration of each load is recorded by screen name (see
+* `SGB_Screen::GetScreenName()`) and, if
+* `SGB_DisplayInitInfo::LoadingHistoryPath` is set, kept on a small
+* file. Later loads of the same screen use it to estimate the remaining
+* time and to advance a smooth progress value even between reports.
+*
+*\code{.cpp}
+*	void MyScreen::LoadScreen()
+*	{
+*		auto progress = GetLoadingProgress();
+*		auto textures = progress->AddTask(3.0f);
+*		auto sounds = progress->AddTask(1.0f);
+*
+*		for (int i = 0; i < textureCount; ++i)
+*		{
+*			//...
+*			progress->SetTaskProgress(textures, (i + 1.0f) / textureCount);
+*		}
+*		//...
+*	}
+*\endcode
+*/
+class SGB_LoadingProgress
+{
+public:
+	SGB_LoadingProgress();
+
+	/*! \brief Registers a task of the current load.
+	*
+	* \param weight How much the task weighs on the whole load, relative
+	* to the other tasks (e.g. its expected duration or size).
+	*
+	* \returns The task identifier, to report its progress. Tasks over
+	* `SGB_LOADING_MAX_TASKS` are ignored.
+	*/
+	Uint32 AddTask(float weight);
+
+	/*! \brief Reports the progress of a task.
+	*
+	* \param task The identifier returned by `AddTask()`.
+	* \param progress The task progress, from 0.0 to 1.0.
+	*
+	* Can be called from any thread.
+	*/
+	void SetTaskProgress(Uint32 task, float progress);
+
+	/*! \brief Gets the weighted progress of all the tasks, from 0.0 to
+	 * 1.0. */
+	float GetProgress();
+
+	/*! \brief Gets a progress value that keeps moving between reports.
+	*
+	* When the duration of a previous load of the same screen is known,
+	* the elapsed time is also taken into account (up to 99%), so the
+	* value moves steadily even if the tasks report in bursts. It never
+	* goes back during a load. Meant to be called by a single thread,
+	* usually the loading screen.
+	*/
+	float GetSmoothProgress();
+
+	/*! \brief Estimates how long the current load will still take.
+	*
+	* \param[out] ticks The estimated remaining time, in milliseconds.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there is an estimate, based on
+	* previous loads of the same screen or on the progress so far,
+	* <b>SGB_FAIL</b> otherwise.
+	*/
+	int GetEstimatedRemainingTicks(Uint32* ticks);
+
+	/*! \brief Gets how long the current (or last) load is taking, in
+	 * milliseconds. */
+	Uint32 GetElapsedTicks();
+
+	/*! \brief Starts tracking a new load, clearing the previous tasks.
+	*
+	* \param screenName The name the duration is recorded with, or NULL
+	* to not record it.
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display before `SGB_Screen::LoadScreen()`.
+	*/
+	void Begin(const char* screenName);
+
+	/*! \brief Finishes tracking the current load.
+	*
+	* \param record If the duration should be recorded; cancelled loads
+	* are not.
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display after `SGB_Screen::LoadScreen()`.
+	*/
+	void End(bool record);
+
+	/*! \brief Reads the recorded load durations from a file.
+	*
+	* \param filePath The file written by `SaveHistory()`. Any
+	* following `End()` writes it back.
+	*
+	* \returns <b>SGB_SUCCESS</b> if the file was read (or does not
+	* exist yet), <b>SGB_FAIL</b> otherwise.
+	*/
+	int LoadHistory(const char* filePath);
+
+	/*! \brief Writes the recorded load durations to the history file.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem (or no file was
+	* set), <b>SGB_FAIL</b> otherwise.
+	*/
+	int SaveHistory();
+
+	SGB_LoadingProgress(const SGB_LoadingProgress&) = delete;
+	SGB_LoadingProgress& operator=(const SGB_LoadingProgress&) = delete;
+
+private:
+	//Guards the task registration, the history and the load start
+	std::mutex _mutex;
+
+	float _taskWeights[SGB_LOADING_MAX_TASKS];
+	std::atomic<float> _taskProgress[SGB_LOADING_MAX_TASKS];
+
+	//Published after the task weight is written
+	std::atomic<Uint32> _taskCount;
+
+	std::string _screenName;
+	std::atomic<Uint64> _startTime;
+	std::atomic<Uint64> _endTime;
+
+	//Recorded duration of the current screen, 0 if unknown
+	std::atomic<Uint64> _expectedDuration;
+
+	//Load seen by the last GetSmoothProgress(), and the value it returned
+	Uint64 _smoothStartTime;
+	float _lastSmoothProgress;
+
+	//Load durations by screen name, in nanoseconds
+	std::map<std::string, Uint64> _history;
+	std::string _historyPath;
+};
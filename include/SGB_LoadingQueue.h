@@ -1,10 +1,86 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include "SGB_types.h"
-#include "SGB_Queue.h"
+#include "SGB_SPSCQueue.h"
+#include "SGB_TripleBuffer.h"
+
+/*! \brief Internal class. Holds SGB_LoadingScreenStatus items between the loading thread and a loading screen.
+*
+* Built on a bounded SGB_SPSCQueue of `SGB_LOADING_QUEUE_SIZE` items, so pushing and pulling never allocate and
+* the loading screen never waits for the loading thread (or the other way around). Producers are serialized among
+* themselves, as `SGB_Screen::LoadScreen()` may push from several jobs at once.
+*
+* Besides the queued history, the latest status is always kept on a SGB_TripleBuffer mailbox, which never drops
+* a status and costs the consumer the same no matter how many statuses were pushed. When the history is not
+* needed, it can be disabled with set_history().
+*/
+class SGB_LoadingQueue
+{
+public:
+	SGB_LoadingQueue();
+
+	/*! \brief Pushes a status at the end of the queue.
+	*
+	* \param item The status to be added.
+	*
+	* \returns <b>true</b> if the status was added, <b>false</b> if the queue is full and it was dropped from the
+	* history (it is still published as the latest status).
+	*/
+	bool push(const SGB_LoadingScreenStatus& item);
+
+	/*! \brief Tries to pop the oldest status of the queue.
+	*
+	* \param[out] item Set to the popped status.
+	*
+	* \returns <b>true</b> if a status was popped, <b>false</b> if the queue is empty.
+	*
+	* Must only be called by the loading screen (the consumer).
+	*/
+	bool try_pop(SGB_LoadingScreenStatus& item);
+
+	/*! \brief Pops every status currently on the queue at once.
+	*
+	* \param[out] items The vector the popped statuses are appended to.
+	*
+	* \returns How many statuses were popped.
+	*
+	* Must only be called by the loading screen (the consumer).
+	*/
+	size_t drain(std::vector<SGB_LoadingScreenStatus>& items);
+
+	/*! \brief Gets the latest status, if any was pushed since the last call.
+	*
+	* \param[out] item Set to the latest status, when there is a new one.
+	*
+	* \returns <b>true</b> if there was a new status, <b>false</b> otherwise.
+	*
+	* Must only be called by the loading screen (the consumer).
+	*/
+	bool pull_latest(SGB_LoadingScreenStatus& item);
+
+	/*! \brief Sets if pushed statuses are also queued as history, besides being published as the latest one.
+	*
+	* \param keepHistory <b>false</b> to only keep the latest status. Defaults to <b>true</b>.
+	*/
+	void set_history(bool keepHistory);
+
+	/*! \brief Checks if there is currently no status on the queue. */
+	bool empty() const;
+
+	SGB_LoadingQueue(const SGB_LoadingQueue&) = delete;
+	SGB_LoadingQueue& operator=(const SGB_LoadingQueue&) = delete;
+
+private:
+	SGB_SPSCQueue<SGB_LoadingScreenStatus> _queue;
+
+	SGB_TripleBuffer<SGB_LoadingScreenStatus> _latest;
 
-/*! \brief Internal class. A SGB_Queue to hold SGB_LoadingScreenStatus items between the loading thread and a loading screen. */
-class SGB_LoadingQueue :
-	public SGB_Queue<SGB_LoadingScreenStatus> {
+	std::atomic<bool> _keepHistory;
 
+	//Keeps a single producer on _queue and _latest at a time; never taken by the consumer
+	std::mutex _producerMutex;
 };
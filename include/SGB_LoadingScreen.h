@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "SGB_SDL.h"
 #include "SGB_Screen.h"
 #include "SGB_LoadingQueue.h"
@@ -68,5 +70,44 @@ protected:
 	*\endcode
 	*/
 	int PullLoadingStatus(SGB_LoadingScreenStatus* status);
+
+	/*! \brief Gets only the newest loading status, skipping any older
+	 * ones.
+	*
+	* \param[out] status The newest status, if there is a new one.
+	*
+	* Returns SGB_SUCCESS if a status was sent since the last call,
+	* that is set on `status`. Unlike PullLoadingStatus(), the cost is
+	* the same no matter how many statuses the loading SGB_Screen
+	* sent, so it fits loading screens that only show the current
+	* progress (see also SetLoadingStatusHistory()).
+	*\code{.cpp}
+	*	if (PullLatestLoadingStatus(&stats) == SGB_SUCCESS)
+	*	{
+	*		_progress = stats.progress;
+	*	}
+	*\endcode
+	*/
+	int PullLatestLoadingStatus(SGB_LoadingScreenStatus* status);
+
+	/*! \brief Gets every queued loading status at once.
+	*
+	* \param[out] statuses The vector the statuses are appended to, in
+	* the order they were sent.
+	*
+	* \returns How many statuses were appended.
+	*
+	* For loading screens that need the whole history, like a log of
+	* every loaded file.
+	*/
+	size_t DrainLoadingStatus(std::vector<SGB_LoadingScreenStatus>& statuses);
+
+	/*! \brief Sets if every loading status is queued for
+	 * PullLoadingStatus() and DrainLoadingStatus().
+	*
+	* \param keepHistory <b>false</b> to only keep the newest status
+	* for PullLatestLoadingStatus(). Defaults to <b>true</b>.
+	*/
+	void SetLoadingStatusHistory(bool keepHistory);
 };
 
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SGB_SDL.h"
+
+class SGB_Display;
+
+/*! \brief Restores the draw color, blend mode and render target of a
+* SGB_Display when it goes out of scope.
+*
+* The state is read from the SGB_Display shadow, with no SDL calls, and
+* restored through the shadowed setters, so only what actually changed
+* inside the scope is sent back to the SDL_Renderer.
+*\code{.cpp}
+*	void MyScreen::Draw()
+*	{
+*		{
+*			SGB_RenderStateGuard guard(_display);
+*
+*			_display->SetRenderTarget(_minimap);
+*			_display->SetDrawColor(GetColor(0x00, 0x40, 0x00));
+*			//...
+*		}
+*
+*		//back to the previous target and color
+*	}
+*\endcode
+*/
+class SGB_RenderStateGuard
+{
+public:
+	/*! \brief Saves the current render state of a SGB_Display.
+	*
+	* \param display The SGB_Display whose state will be restored.
+	*/
+	SGB_RenderStateGuard(SGB_Display* display);
+
+	/*! \brief Restores the saved render state. */
+	~SGB_RenderStateGuard();
+
+	SGB_RenderStateGuard(const SGB_RenderStateGuard&) = delete;
+	SGB_RenderStateGuard& operator=(const SGB_RenderStateGuard&) = delete;
+
+private:
+	SGB_Display* _display;
+
+	SDL_Color _drawColor;
+	SDL_BlendMode _blendMode;
+	SDL_Texture* _renderTarget;
+};
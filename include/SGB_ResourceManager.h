@@ -0,0 +1,190 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SGB_SDL.h"
+#include "SGB_types.h"
+
+/*! \brief A resource shared through a SGB_ResourceManager.
+*
+* Instances are only created by `SGB_ResourceManager::Acquire()` and
+* stay valid until given back to `SGB_ResourceManager::Release()`.
+*/
+class SGB_Resource
+{
+public:
+	/*! \brief Gets what the load function returned. */
+	void* GetData();
+
+	/*! \brief Gets the key the resource was acquired with. */
+	const char* GetKey();
+
+	/*! \brief Gets the size reported by the load function, in bytes. */
+	Uint64 GetSize();
+
+	SGB_Resource(const SGB_Resource&) = delete;
+	SGB_Resource& operator=(const SGB_Resource&) = delete;
+
+private:
+	friend class SGB_ResourceManager;
+
+	SGB_Resource(const std::string& key);
+
+	std::string _key;
+	void* _data;
+	Uint64 _size;
+
+	//Frees _data, on the main thread
+	std::function<void(void*)> _unload;
+
+	Uint32 _references;
+
+	//Indicates that the load function is still running on some thread
+	bool _loading;
+
+	//When the last reference was released
+	Uint64 _releaseTime;
+
+	//Position on the unreferenced list, while there are no references
+	std::list<SGB_Resource*>::iterator _unreferencedPosition;
+};
+
+/*! \brief Shares resources, by key, between the SGB_Screen's and keeps
+* them loaded a little after they are no longer used.
+*
+* Screens acquire what they need on `SGB_Screen::LoadScreen()` and
+* release it on `SGB_Screen::UnloadScreen()`. A resource already loaded
+* (or still referenced by the previous screen) is shared instead of
+* loaded again, and one released by every screen is only unloaded after
+* `SGB_DisplayInitInfo::ResourceUnloadDelay`, or earlier if the
+* unreferenced ones go over `SGB_DisplayInitInfo::ResourceCacheBudget`
+* (the least recently released first). So a tileset used by two
+* consecutive screens is loaded only once.
+*
+*\code{.cpp}
+*	void MyScreen::LoadScreen()
+*	{
+*		_tiles = _display->GetResourceManager()->Acquire("tiles",
+*			[](Uint64* size) -> void* {
+*				auto tiles = new Tileset("tiles.png");
+*				*size = tiles->GetMemoryUsage();
+*				return tiles;
+*			},
+*			[](void* data) {
+*				delete (Tileset*)data;
+*			});
+*	}
+*
+*	void MyScreen::UnloadScreen()
+*	{
+*		_display->GetResourceManager()->Release(_tiles);
+*	}
+*\endcode
+*
+* Acquiring and releasing are safe from any thread. Unloading only
+* happens on the main thread, during `SGB_Display::Update()`, so the
+* unload function may destroy textures.
+*/
+class SGB_ResourceManager
+{
+public:
+	SGB_ResourceManager();
+
+	/*! \brief Unloads every resource left. */
+	~SGB_ResourceManager();
+
+	/*! \brief Prepares the resource manager.
+	*
+	* \param info The `SGB_DisplayInitInfo` generated by the parent `SGB_Display`.
+	*/
+	void Setup(SGB_DisplayInitInfo info);
+
+	/*! \brief Gets a resource, loading it if it is not resident yet.
+	*
+	* \param key Identifies the resource, e.g. its file path.
+	* \param load Called on the calling thread if the resource is not
+	* resident, returning the loaded data (or NULL if it failed) and
+	* setting its size in bytes.
+	* \param unload Called on the main thread to free the data.
+	*
+	* \returns The resource, with a new reference, or NULL if it could
+	* not be loaded. If another thread is loading the same key, it waits
+	* for that load instead of loading it again.
+	*/
+	SGB_Resource* Acquire(const char* key,
+		std::function<void*(Uint64*)> load,
+		std::function<void(void*)> unload);
+
+	/*! \brief Gets a resource only if it is already resident.
+	*
+	* \param key Identifies the resource.
+	*
+	* \returns The resource, with a new reference, or NULL if it is not
+	* loaded. Never loads anything.
+	*/
+	SGB_Resource* Find(const char* key);
+
+	/*! \brief Gives back a reference taken by `Acquire()` or `Find()`.
+	*
+	* \param resource The resource, which must not be used afterwards.
+	* NULL is ignored.
+	*
+	* The resource is only unloaded later, by `Update()`.
+	*/
+	void Release(SGB_Resource* resource);
+
+	/*! \brief Unloads the unreferenced resources that expired or go
+	 * over the cache budget.
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display on each loop cycle.
+	*/
+	void Update();
+
+	/*! \brief Unloads every unreferenced resource right away.
+	*
+	* Must be called on the main thread.
+	*/
+	void Clear();
+
+	/*! \brief Gets the size of the unreferenced resources still
+	 * loaded, in bytes. */
+	Uint64 GetCachedSize();
+
+	/*! \brief Gets how many resources are loaded or being loaded,
+	 * referenced or not. */
+	Uint32 GetResourceCount();
+
+	SGB_ResourceManager(const SGB_ResourceManager&) = delete;
+	SGB_ResourceManager& operator=(const SGB_ResourceManager&) = delete;
+
+private:
+	/*! \brief Drops a reference to a resource whose load failed,
+	 * deleting it with the last one. Expects _mutex to be locked. */
+	void DropFailed(SGB_Resource* resource);
+
+	/*! \brief Unloads and deletes resources taken out of the manager. */
+	void Unload(std::vector<SGB_Resource*>& resources);
+
+	SGB_DisplayInitInfo _initInfo;
+
+	//Guards every field below and the fields of every resource
+	std::mutex _mutex;
+
+	//Wakes threads waiting for a resource being loaded by another one
+	std::condition_variable _loadedCondition;
+
+	std::unordered_map<std::string, SGB_Resource*> _resources;
+
+	//Resources with no references, from the most to the least recently released
+	std::list<SGB_Resource*> _unreferenced;
+
+	//Sum of the sizes on _unreferenced
+	Uint64 _cachedSize;
+};
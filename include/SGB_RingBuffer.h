@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+/*! \brief Internal class. A fixed capacity circular buffer.
+*
+* Once full, each new element overwrites the oldest one, so pushing
+* never allocates and always takes constant time.
+*
+* Not thread-safe.
+*/
+template <typename T>
+class SGB_RingBuffer
+{
+public:
+
+	/*! \brief Creates an empty buffer with the given capacity. */
+	explicit SGB_RingBuffer(size_t capacity = 0)
+	{
+		reset(capacity);
+	}
+
+	/*! \brief Removes all elements and sets a new capacity.
+	*
+	* \param capacity How many elements the buffer will hold.
+	*/
+	void reset(size_t capacity)
+	{
+		buffer_.assign(capacity, T());
+		head_ = 0;
+		size_ = 0;
+	}
+
+	/*! \brief Removes all elements, keeping the capacity. */
+	void clear()
+	{
+		head_ = 0;
+		size_ = 0;
+	}
+
+	/*! \brief Pushes an element at the end of the buffer.
+	*
+	* \param item The item to be added.
+	*
+	* If the buffer is full, the oldest element is overwritten.
+	* Check it with full() and front() before pushing when the
+	* evicted value is needed, like when keeping a running sum.
+	*/
+	void push(const T& item)
+	{
+		if (buffer_.empty())
+		{
+			return;
+		}
+
+		buffer_[(head_ + size_) % buffer_.size()] = item;
+
+		if (size_ < buffer_.size())
+		{
+			++size_;
+		}
+		else
+		{
+			head_ = (head_ + 1) % buffer_.size();
+		}
+	}
+
+	/*! \brief Gets the oldest element. The buffer must not be empty. */
+	const T& front() const
+	{
+		return buffer_[head_];
+	}
+
+	/*! \brief Gets the newest element. The buffer must not be empty. */
+	const T& back() const
+	{
+		return buffer_[(head_ + size_ - 1) % buffer_.size()];
+	}
+
+	/*! \brief Gets an element by its age, 0 being the oldest one. */
+	const T& operator[](size_t index) const
+	{
+		return buffer_[(head_ + index) % buffer_.size()];
+	}
+
+	/*! \brief Returns how many elements are currently stored. */
+	size_t size() const
+	{
+		return size_;
+	}
+
+	/*! \brief Returns how many elements can be stored. */
+	size_t capacity() const
+	{
+		return buffer_.size();
+	}
+
+	/*! \brief Checks if there is currently no elements on the buffer. */
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+	/*! \brief Checks if the next push() will overwrite an element. */
+	bool full() const
+	{
+		return size_ == buffer_.size();
+	}
+
+private:
+	std::vector<T> buffer_;
+	size_t head_;
+	size_t size_;
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+/*! \brief Defines the cache line size used to keep the producer and
+* consumer data of a SGB_SPSCQueue apart. */
+#ifndef SGB_CACHE_LINE_SIZE
+#define SGB_CACHE_LINE_SIZE 64
+#endif
+
+/*! \brief Internal class. A bounded, lock-free, single-producer and
+* single-consumer queue.
+*
+* Exactly one thread may push and exactly one (possibly other) thread
+* may pop. Neither side ever blocks or allocates: try_push() fails when
+* the queue is full and try_pop() fails when it is empty.
+*
+* The producer and consumer positions live on different cache lines,
+* so both threads can work on the queue without invalidating each
+* other's cache on every operation.
+*/
+template <typename T>
+class SGB_SPSCQueue
+{
+public:
+
+	/*! \brief Creates a queue able to hold at least `capacity` elements.
+	*
+	* The capacity is rounded up to the next power of two.
+	*/
+	explicit SGB_SPSCQueue(size_t capacity)
+	{
+		size_t size = 2;
+
+		//one slot is always kept empty to tell full from empty
+		while (size < capacity + 1)
+		{
+			size <<= 1;
+		}
+
+		buffer_.resize(size);
+		mask_ = size - 1;
+
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_relaxed);
+		cachedHead_ = 0;
+		cachedTail_ = 0;
+	}
+
+	/*! \brief Tries to push an element at the end of the queue.
+	*
+	* \param item The item to be added at the end of the queue.
+	*
+	* \returns <b>true</b> if the item was added, <b>false</b> if the
+	* queue is full.
+	*
+	* Must only be called by the producer thread.
+	*/
+	bool try_push(const T& item)
+	{
+		auto tail = tail_.load(std::memory_order_relaxed);
+		auto next = (tail + 1) & mask_;
+
+		if (next == cachedHead_)
+		{
+			cachedHead_ = head_.load(std::memory_order_acquire);
+
+			if (next == cachedHead_)
+			{
+				return false;
+			}
+		}
+
+		buffer_[tail] = item;
+		tail_.store(next, std::memory_order_release);
+
+		return true;
+	}
+
+	/*! \brief Tries to pop the next element of the queue.
+	*
+	* \param[out] item Set to the popped item.
+	*
+	* \returns <b>true</b> if an item was popped, <b>false</b> if the
+	* queue is empty.
+	*
+	* Must only be called by the consumer thread.
+	*/
+	bool try_pop(T& item)
+	{
+		auto head = head_.load(std::memory_order_relaxed);
+
+		if (head == cachedTail_)
+		{
+			cachedTail_ = tail_.load(std::memory_order_acquire);
+
+			if (head == cachedTail_)
+			{
+				return false;
+			}
+		}
+
+		item = buffer_[head];
+		head_.store((head + 1) & mask_, std::memory_order_release);
+
+		return true;
+	}
+
+	/*! \brief Pops every element currently on the queue at once.
+	*
+	* \param[out] items The vector the popped items are appended to.
+	* \param maxItems The maximum amount of items to be popped.
+	*
+	* \returns How many items were popped.
+	*
+	* Synchronizes with the producer only once for the whole batch.
+	* Must only be called by the consumer thread.
+	*/
+	size_t drain(std::vector<T>& items, size_t maxItems = (size_t)-1)
+	{
+		auto head = head_.load(std::memory_order_relaxed);
+		cachedTail_ = tail_.load(std::memory_order_acquire);
+
+		size_t count = 0;
+
+		while (head != cachedTail_ && count < maxItems)
+		{
+			items.push_back(buffer_[head]);
+			head = (head + 1) & mask_;
+			++count;
+		}
+
+		head_.store(head, std::memory_order_release);
+
+		return count;
+	}
+
+	/*! \brief Checks if there is currently no elements on the queue.
+	*
+	* The answer may already be outdated when it returns, if the other
+	* thread is working on the queue.
+	*/
+	bool empty() const
+	{
+		return head_.load(std::memory_order_acquire) ==
+			tail_.load(std::memory_order_acquire);
+	}
+
+	/*! \brief Returns an approximation of the current size of the queue. */
+	size_t size() const
+	{
+		auto head = head_.load(std::memory_order_acquire);
+		auto tail = tail_.load(std::memory_order_acquire);
+
+		return (tail - head) & mask_;
+	}
+
+	/*! \brief Returns how many elements the queue can hold. */
+	size_t capacity() const
+	{
+		return mask_;
+	}
+
+	SGB_SPSCQueue(const SGB_SPSCQueue&) = delete;            // disable copying
+	SGB_SPSCQueue& operator=(const SGB_SPSCQueue&) = delete; // disable assignment
+
+private:
+	std::vector<T> buffer_;
+	size_t mask_;
+
+	char padding0_[SGB_CACHE_LINE_SIZE];
+
+	//consumer side: next slot to be read and its view of tail_
+	std::atomic<size_t> head_;
+	size_t cachedTail_;
+
+	char padding1_[SGB_CACHE_LINE_SIZE];
+
+	//producer side: next slot to be written and its view of head_
+	std::atomic<size_t> tail_;
+	size_t cachedHead_;
+
+	char padding2_[SGB_CACHE_LINE_SIZE];
+};
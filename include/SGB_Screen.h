@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <vector>
+
 #include "SGB_SDL.h"
 #include "SGB_Display.h"
 #include "SGB_LoadingQueue.h"
+#include "SGB_LoadingProgress.h"
+#include "SGB_TextureAtlas.h"
 
 class SGB_Display;
 
@@ -62,6 +67,22 @@ public:
 	*/
 	virtual void ScreenShow() {};
 
+	/*! \brief Process the SDL events received since the last loop
+	 * cycle.
+	*
+	* \param events All the events taken from SDL's queue on this loop
+	* cycle, in the order they happened.
+	*
+	* Called by the SGB_Display on the main thread, before
+	* `Update()`, only when there is at least one event. SDL's queue is
+	* already drained (and pumped) at this point, so there is no need
+	* to call `SDL_PollEvent()` or `SDL_PumpEvents()`;
+	* `SDL_GetKeyboardState()` and similar functions are up to date.
+	*
+	* `SDL_QUIT` events are also handled by the SGB_Display itself.
+	*/
+	virtual void HandleEvents(const std::vector<SDL_Event>& /*events*/) {};
+
 	/*! \brief Process a delta-time iteration.
 	*
 	* The SGB_Screen's logic calculations will usually be done here.
@@ -89,6 +110,29 @@ public:
 	*/
 	virtual void UnloadScreen() {};
 
+	/*! \brief Reports how much memory the SGB_Screen resources use,
+	 * in bytes.
+	*
+	* Used to check `SGB_DisplayInitInfo::ScreenMemoryBudget`. Before
+	* LoadScreen() runs, it should return the expected usage (or 0 if
+	* unknown). Called on the main thread, never while LoadScreen() or
+	* UnloadScreen() is running.
+	*/
+	virtual Uint64 GetMemoryUsage() { return 0; };
+
+	/*! \brief Identifies the SGB_Screen on the screen cache and on the
+	 * recorded load durations.
+	*
+	* \returns A name shared by every instance of the same screen, or
+	* NULL (the default) to never cache it nor record how long it takes
+	* to load (see SGB_LoadingProgress).
+	*
+	* See `SGB_DisplayInitInfo::ScreenCacheBudget`. A cached screen is
+	* reused across visits, so ScreenShow() must reset any state that
+	* should not carry over.
+	*/
+	virtual const char* GetScreenName() { return NULL; };
+
 	/*! \brief Connects a SGB_LoadingScreen's SGB_LoadingQueue to this
 	 * SGB_Screen.
 	*
@@ -101,6 +145,75 @@ public:
 	*/
 	void SetLoadingQueue(SGB_Screen* loadingScreen);
 
+	/*! \brief Checks if LoadScreen() already finished for this
+	 * SGB_Screen instance.
+	*
+	* Can be called from any thread.
+	*/
+	bool IsLoaded();
+
+	/*! \brief Flags if LoadScreen() finished for this SGB_Screen
+	 * instance.
+	*
+	* \param loaded <b>true</b> after LoadScreen(), <b>false</b> after
+	* UnloadScreen().
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display while loading and unloading the
+	* SGB_Screen.
+	*/
+	void SetLoaded(bool loaded);
+
+	/*! \brief Asks a running LoadScreen() to stop as soon as possible.
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display when another SGB_Screen is set while
+	* this one is still loading. See IsLoadCancelled().
+	*/
+	void CancelLoad();
+
+	/*! \brief Withdraws a CancelLoad(), once the cancelled load
+	 * returned and was undone by UnloadScreen().
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display before loading this SGB_Screen again,
+	* when it was set again while its cancelled load was running.
+	*/
+	void ResetCancelLoad();
+
+	/*! \brief Checks if the load of this SGB_Screen was cancelled.
+	*
+	* LoadScreen() (and any job it started) should poll it between
+	* steps and return early when it is <b>true</b>, as the SGB_Screen
+	* will not be shown: UnloadScreen() is called right after, to
+	* release whatever was already loaded, and then the instance is
+	* deleted (or loaded again, if it was set again meanwhile). Can be
+	* called from any thread.
+	*/
+	bool IsLoadCancelled();
+
+	/*! \brief Called on the main thread once every texture queued with
+	 * QueueTextureUpload() was created.
+	*
+	* When the uploads were queued by LoadScreen(), the SGB_Screen is
+	* only shown after this call.
+	*/
+	virtual void TexturesReady() {};
+
+	/*! \brief Checks if there are textures queued with
+	 * QueueTextureUpload() not created yet.
+	*/
+	bool HasPendingUploads();
+
+	/*! \brief Signals that one of the queued textures was created.
+	*
+	* \returns <b>true</b> if it was the last pending one.
+	*
+	* This method is not intended to be called manually, as it is
+	* executed by the SGB_Display after creating each texture.
+	*/
+	bool FinishTextureUpload();
+
 protected:
 
 	/*! \brief Signals the SGB_Display to change SGB_Screen's.
@@ -148,7 +261,9 @@ protected:
 	*
 	* Uses SGB_Display::GetDrawColor and SGB_Display::SetDrawColor to
 	* temporarily set the render color and draw a "full" rectangle,
-	* going back to the previous render color when done.
+	* going back to the previous render color when done. With
+	* `SGB_DisplayInitInfo::BatchDraws` set, it is recorded on the
+	* SGB_DrawBatch instead, as every other rectangle helper.
 	*/
 	void FillRect(SDL_Rect rect, SDL_Color color);
 
@@ -177,6 +292,32 @@ protected:
 	*/
 	void FillRect(SDL_Rect rect);
 
+	/*! \brief Renders the rectangles recorded so far, when
+	 * `SGB_DisplayInitInfo::BatchDraws` is set.
+	*
+	* The SGB_Display flushes them after Draw(), so it is only needed
+	* before drawing anything that must appear over them (e.g. a
+	* texture) or rectangles overlapping others with a different color.
+	*/
+	void FlushDraws();
+
+	/*! \brief Marks the whole frame to be rendered again.
+	*
+	* A shortcut that calls SGB_Display::Invalidate(). Only needed with
+	* `SGB_DisplayInitInfo::RenderOnChange`, usually from Update() or
+	* HandleEvents() when something shown changed. Must not be called
+	* from LoadScreen(), which runs on the loader thread.
+	*/
+	void Invalidate();
+
+	/*! \brief Marks an area of the frame to be rendered again.
+	*
+	* \param rect The area that changed.
+	*
+	* A shortcut that calls SGB_Display::Invalidate(SDL_Rect).
+	*/
+	void Invalidate(SDL_Rect rect);
+
 	/*! \brief Gets the current renderer's width and height.
 	*
 	* \param[out] width The current renderer width.
@@ -221,9 +362,57 @@ protected:
 	* will be put at the end of the queue, being accessed
 	* by a SGB_LoadingScreen instance's
 	* SGB_LoadingScreen::PullLoadingStatus method.
+	*
+	* It never blocks: if the loading screen falls behind by more than
+	* `SGB_LOADING_QUEUE_SIZE` messages, the new ones are dropped.
 	*/
 	void PushLoadingStatus(SGB_LoadingScreenStatus status);
 
+	/*! \brief Queues a surface to be turned into a texture on the main
+	 * thread.
+	*
+	* \param surface The decoded surface, that will be freed by the
+	* SGB_Display once the texture is created.
+	* \param[out] texture Where the created texture will be stored.
+	* Set to NULL if it could not be created.
+	*
+	* SDL_Renderer functions must only be used by the main thread, so
+	* LoadScreen() (or any job it started) should only decode images
+	* into SDL_Surface's and leave the texture creation to the
+	* SGB_Display, that does it on `SGB_Display::Update()` within
+	* `SGB_DisplayInitInfo::TextureUploadBudget`. TexturesReady() is
+	* called once all of them are created. Can be called from any
+	* thread. Uploads still queued when the SGB_Screen is unloaded are
+	* dropped, leaving their textures untouched.
+	*\code{.cpp}
+	*	void MyScreen::LoadScreen()
+	*	{
+	*		SDL_Surface* surface = IMG_Load("player.png");
+	*		QueueTextureUpload(surface, &_playerTexture);
+	*	}
+	*\endcode
+	*/
+	void QueueTextureUpload(SDL_Surface* surface, SDL_Texture** texture);
+
+	/*! \brief Queues the packed pages of a SGB_TextureAtlas to be
+	 * turned into textures on the main thread.
+	*
+	* \param atlas An atlas already packed with
+	* `SGB_TextureAtlas::Pack()`.
+	*
+	* Works as QueueTextureUpload() for each page, so TexturesReady() is
+	* also called once the pages are created.
+	*/
+	void QueueAtlasUpload(SGB_TextureAtlas* atlas);
+
+	/*! \brief Gets the progress tracker of the current load, to
+	 * register weighted tasks on LoadScreen() and report their progress.
+	*
+	* See SGB_LoadingProgress. Can be called from any thread, so jobs
+	* started by LoadScreen() can report their own tasks.
+	*/
+	SGB_LoadingProgress* GetLoadingProgress();
+
 	/*! \brief Holds the SGB_Display instance set by SetDisplay() */
 	SGB_Display* _display;
 
@@ -239,5 +428,15 @@ protected:
 	*/
 	SGB_LoadingQueue* _statusQueue;
 
+private:
+	/*! \brief Holds the value set by SetLoaded(). */
+	std::atomic<bool> _loaded;
+
+	/*! \brief Holds the value set by CancelLoad(). */
+	std::atomic<bool> _loadCancelled;
+
+	/*! \brief Holds how many queued textures were not created yet. */
+	std::atomic<Uint32> _pendingUploads;
+
 };
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+
+#include "SGB_SDL.h"
+
+class SGB_TextureAtlas;
+
+/*! \brief Records sprites to be drawn and renders each run of sprites
+* sharing a texture with a single SDL call.
+*
+* Sprites are rendered in the order they were recorded, so the ones
+* drawn one after the other from the same SGB_TextureAtlas page (or
+* the same texture) end up in one `SDL_RenderGeometry()` call. When
+* built against SDL older than 2.0.18, which has no
+* `SDL_RenderGeometry()`, each sprite falls back to `SDL_RenderCopy()`.
+*
+*\code{.cpp}
+*	void MyScreen::Draw()
+*	{
+*		for (auto& enemy : _enemies)
+*		{
+*			_sprites.Draw(&_atlas, _enemySprite, enemy.x, enemy.y);
+*		}
+*
+*		_sprites.Draw(&_atlas, _playerSprite, _player.x, _player.y);
+*		_sprites.Flush();
+*	}
+*\endcode
+*/
+class SGB_SpriteBatch
+{
+public:
+	SGB_SpriteBatch();
+
+	/*! \brief Sets the SDL_Renderer the recorded sprites are rendered
+	 * with, usually `SGB_Screen::_renderer`. */
+	void SetRenderer(SDL_Renderer* renderer);
+
+	/*! \brief Records an area of a texture to be drawn.
+	*
+	* \param texture The texture to be drawn.
+	* \param source The area of the texture to be drawn.
+	* \param destination Where it is drawn, scaled to fit.
+	* \param color Multiplied with the texture pixels, white (the
+	* default) keeping them as they are.
+	*/
+	void Draw(SDL_Texture* texture, const SDL_Rect& source,
+		const SDL_Rect& destination, SDL_Color color = { 0xff, 0xff, 0xff, 0xff });
+
+	/*! \brief Records a sprite of a SGB_TextureAtlas to be drawn with
+	 * its own size.
+	*
+	* \param atlas The atlas holding the sprite, with its textures created.
+	* \param sprite The identifier returned by `SGB_TextureAtlas::AddSurface()`.
+	* \param x Where the left of the sprite is drawn.
+	* \param y Where the top of the sprite is drawn.
+	*/
+	void Draw(SGB_TextureAtlas* atlas, Uint32 sprite, int x, int y);
+
+	/*! \brief Records a sprite of a SGB_TextureAtlas to be drawn.
+	*
+	* \param atlas The atlas holding the sprite, with its textures created.
+	* \param sprite The identifier returned by `SGB_TextureAtlas::AddSurface()`.
+	* \param destination Where it is drawn, scaled to fit.
+	* \param color Multiplied with the sprite pixels.
+	*/
+	void Draw(SGB_TextureAtlas* atlas, Uint32 sprite,
+		const SDL_Rect& destination, SDL_Color color = { 0xff, 0xff, 0xff, 0xff });
+
+	/*! \brief Renders every recorded sprite and clears the batch.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise.
+	*/
+	int Flush();
+
+	SGB_SpriteBatch(const SGB_SpriteBatch&) = delete;
+	SGB_SpriteBatch& operator=(const SGB_SpriteBatch&) = delete;
+
+private:
+	struct Sprite
+	{
+		SDL_Texture* texture;
+		SDL_Rect source;
+		SDL_Rect destination;
+		SDL_Color color;
+	};
+
+	/*! \brief Renders the recorded sprites from `first` to `last`
+	 * (exclusive), which share the same texture. */
+	int RenderRun(size_t first, size_t last);
+
+	SDL_Renderer* _renderer;
+
+	//Recorded since the last Flush(), kept allocated between frames
+	std::vector<Sprite> _sprites;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	//Geometry of the run being rendered
+	std::vector<SDL_Vertex> _vertices;
+	std::vector<int> _indices;
+#endif
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "SGB_SDL.h"
+
+/*! \brief Where a sprite added to a SGB_TextureAtlas was packed. */
+struct SGB_AtlasSprite
+{
+	/*! \brief The atlas page holding the sprite. */
+	Uint32 page;
+
+	/*! \brief The area of the page holding the sprite. */
+	SDL_Rect rect;
+};
+
+/*! \brief Packs many small surfaces into a few large textures.
+*
+* Each texture switch breaks a batch of draw calls, so sprites drawn
+* together should live on the same texture. The atlas takes the
+* surfaces of the sprites, packs them with a skyline packer into as few
+* pages as possible and creates a texture for each page.
+*
+* Adding and packing only use SDL_Surface's, so it can (and should) be
+* done on `SGB_Screen::LoadScreen()`, with the textures created on the
+* main thread by `SGB_Screen::QueueAtlasUpload()`:
+*\code{.cpp}
+*	void MyScreen::LoadScreen()
+*	{
+*		_player = _atlas.AddSurface(IMG_Load("player.png"));
+*		_enemy = _atlas.AddSurface(IMG_Load("enemy.png"));
+*
+*		_atlas.Pack();
+*		QueueAtlasUpload(&_atlas);
+*	}
+*\endcode
+*
+* The sprites are then drawn with a SGB_SpriteBatch.
+*/
+class SGB_TextureAtlas
+{
+public:
+	/*! \brief Creates an empty atlas.
+	*
+	* \param pageWidth The width of each page, in pixels.
+	* \param pageHeight The height of each page, in pixels.
+	*
+	* The page size must not be over the SDL_RendererInfo
+	* max_texture_width and max_texture_height of the renderer; 2048 is
+	* supported almost everywhere.
+	*/
+	SGB_TextureAtlas(int pageWidth = 2048, int pageHeight = 2048);
+
+	/*! \brief Frees the surfaces and destroys the page textures. */
+	~SGB_TextureAtlas();
+
+	/*! \brief Adds a sprite to be packed, taking ownership of its surface.
+	*
+	* \param surface The sprite pixels, freed by the atlas once packed.
+	*
+	* \returns The sprite identifier, to be used with `GetSprite()` and
+	* SGB_SpriteBatch.
+	*/
+	Uint32 AddSurface(SDL_Surface* surface);
+
+	/*! \brief Packs the added sprites into page surfaces.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise (e.g. a sprite bigger than a page).
+	*
+	* Only uses SDL_Surface's, so it can run on any thread.
+	*/
+	int Pack();
+
+	/*! \brief Creates the page textures right away.
+	*
+	* \param renderer The SDL_Renderer the textures are created for.
+	*
+	* \returns <b>SGB_SUCCESS</b> if there's no problem,
+	* <b>SGB_FAIL</b> otherwise.
+	*
+	* Must be called on the main thread. From `SGB_Screen::LoadScreen()`
+	* use `SGB_Screen::QueueAtlasUpload()` instead.
+	*/
+	int CreateTextures(SDL_Renderer* renderer);
+
+	/*! \brief Gets where a sprite was packed.
+	*
+	* \param sprite The identifier returned by `AddSurface()`.
+	* \param[out] result The page and area holding the sprite.
+	*
+	* \returns <b>SGB_SUCCESS</b> if the sprite was packed,
+	* <b>SGB_FAIL</b> otherwise.
+	*/
+	int GetSprite(Uint32 sprite, SGB_AtlasSprite* result);
+
+	/*! \brief Gets how many pages `Pack()` created. */
+	Uint32 GetPageCount();
+
+	/*! \brief Gets the texture of a page, or NULL if not created yet. */
+	SDL_Texture* GetPageTexture(Uint32 page);
+
+	/*! \brief Internal method. Takes the packed surface of a page,
+	 * leaving the caller responsible for freeing it. */
+	SDL_Surface* TakePageSurface(Uint32 page);
+
+	/*! \brief Internal method. Gets where the texture of a page is
+	 * stored, to be filled by `SGB_Display::QueueTextureUpload()`. */
+	SDL_Texture** GetPageTextureSlot(Uint32 page);
+
+	/*! \brief Frees every sprite, page surface and page texture. */
+	void Clear();
+
+	SGB_TextureAtlas(const SGB_TextureAtlas&) = delete;
+	SGB_TextureAtlas& operator=(const SGB_TextureAtlas&) = delete;
+
+private:
+	struct SkylineNode
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	struct Page
+	{
+		SDL_Surface* surface;
+		SDL_Texture* texture;
+
+		//Top edge of the packed area, from left to right
+		std::vector<SkylineNode> skyline;
+	};
+
+	struct Sprite
+	{
+		SDL_Surface* surface;
+		SGB_AtlasSprite packed;
+		bool isPacked;
+	};
+
+	/*! \brief Finds the lowest position on a page skyline where a
+	 * rectangle fits.
+	 *
+	 * \returns <b>true</b> if it fits, with the skyline node it starts
+	 * on and its position.
+	 */
+	bool FindPosition(Page& page, int width, int height,
+		size_t* node, int* x, int* y);
+
+	/*! \brief Raises a page skyline over a newly placed rectangle. */
+	void PlaceRect(Page& page, size_t node, int x, int y, int width, int height);
+
+	/*! \brief Adds an empty page, with its surface. */
+	int AddPage();
+
+	int _pageWidth;
+	int _pageHeight;
+
+	std::vector<Sprite> _sprites;
+
+	//A deque, as a later Pack() adds pages while the texture slots of
+	//the earlier ones may still be waiting for their uploads
+	std::deque<Page> _pages;
+};
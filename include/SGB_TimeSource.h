@@ -0,0 +1,78 @@
+#pragma once
+
+#include "SGB_SDL.h"
+
+/*! \brief Provides the time used by a `SGB_Display` to run its loop.
+*
+* The default time source follows the real time (see `SGB_SystemTimeSource`).
+* Custom ones can be given to `SGB_Display::SetTimeSource()`, for example
+* to run a screen faster than real time with reproducible delta times
+* (see `SGB_ManualTimeSource`).
+*/
+class SGB_TimeSource
+{
+public:
+	virtual ~SGB_TimeSource() {};
+
+	/*! \brief Gets the current time, in nanoseconds.
+	*
+	* The starting point is arbitrary, but the values must never
+	* decrease.
+	*/
+	virtual Uint64 GetNanoseconds() = 0;
+
+	/*! \brief Called once at the start of each loop cycle, before the
+	 * time is read.
+	*/
+	virtual void Tick() {};
+
+	/*! \brief Indicates if the time follows the real time.
+	*
+	* When false, `SGB_Display` will not wait for the next frame with
+	* `SGB_DisplayInitInfo::PaceFrames`, running as fast as possible.
+	*/
+	virtual bool IsRealTime() { return true; };
+};
+
+/*! \brief Default time source, reading the real time from `SGB_Clock`. */
+class SGB_SystemTimeSource : public SGB_TimeSource
+{
+public:
+	virtual Uint64 GetNanoseconds() override;
+};
+
+/*! \brief A virtual clock that only moves a fixed step on each loop cycle.
+*
+* Every `SGB_Display::Update()` sees exactly the same delta time,
+* regardless of how long it took to run, making runs deterministic and
+* as fast as the CPU allows. To render every cycle, use a step no
+* shorter than the frame interval set by `SGB_DisplayInitInfo::TargetFrameRate`.
+*/
+class SGB_ManualTimeSource : public SGB_TimeSource
+{
+public:
+	/*! \brief Creates the clock, starting at zero.
+	*
+	* \param stepNanoseconds How much the clock moves on each loop cycle.
+	*/
+	SGB_ManualTimeSource(Uint64 stepNanoseconds);
+
+	virtual Uint64 GetNanoseconds() override;
+
+	/*! \brief Moves the clock by the current step. */
+	virtual void Tick() override;
+
+	virtual bool IsRealTime() override;
+
+	/*! \brief Changes how much the clock moves on each loop cycle. */
+	void SetStep(Uint64 stepNanoseconds);
+
+	/*! \brief Moves the clock by an arbitrary amount of nanoseconds,
+	 * for example to simulate a slow frame.
+	*/
+	void Advance(Uint64 nanoseconds);
+
+private:
+	Uint64 _currentTime;
+	Uint64 _step;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "SGB_SDL.h"
+#include "SGB_Clock.h"
+
+/*! \brief Defines if the trace event recording is compiled.
+*
+* When defined as 0, `SGB_TRACE_SCOPE()` compiles to nothing and
+* SGB_Tracer never records any event.
+*/
+#ifndef SGB_ENABLE_TRACER
+#define SGB_ENABLE_TRACER 1
+#endif
+
+/*! \brief Defines how many trace events each thread can have waiting
+* to be written to the file. Events recorded on a full buffer are dropped. */
+#ifndef SGB_TRACE_BUFFER_SIZE
+#define SGB_TRACE_BUFFER_SIZE 16384
+#endif
+
+/*! \brief Records Chrome/Perfetto trace events to a JSON file.
+*
+* The resulting file can be opened on `chrome://tracing` or
+* https://ui.perfetto.dev, showing what each thread was doing over
+* time. `SGB_Display::Update()` records each of its phases and the
+* loading thread records `SGB_Screen::UnloadScreen()` and
+* `SGB_Screen::LoadScreen()`, so hitches on the main thread can be
+* matched with what the loader was doing at the same moment.
+*
+* Each thread records its events on its own lock-free buffer, so
+* recording never waits for another thread. A background thread
+* periodically collects the buffers and writes the file.
+*
+* Custom spans can be recorded with `SGB_TRACE_SCOPE()`:
+*\code{.cpp}
+*	void MyScreen::LoadScreen()
+*	{
+*		SGB_TRACE_SCOPE("MyScreen::LoadTextures");
+*		//... everything until the end of the scope is measured
+*	}
+*\endcode
+*/
+class SGB_Tracer
+{
+public:
+
+	/*! \brief Starts recording trace events to a file.
+	*
+	* \param filePath The path of the JSON file to be written.
+	*
+	* \returns <b>SGB_SUCCESS</b> if the file could be created,
+	* <b>SGB_FAIL</b> otherwise (or if a trace is already running).
+	*/
+	static int Start(const char* filePath);
+
+	/*! \brief Stops recording, writing all pending events and closing
+	 * the file. */
+	static void Stop();
+
+	/*! \brief Checks if trace events are being recorded. */
+	static bool IsActive();
+
+	/*! \brief Names the calling thread on the trace.
+	*
+	* \param name The name to be shown. Must be a string literal (or
+	* otherwise outlive the trace).
+	*
+	* Only stores the name: the event buffer of a thread is allocated
+	* when it records its first event on an active trace. Use it
+	* through `SGB_TRACE_THREAD_NAME()`.
+	*/
+	static void SetThreadName(const char* name);
+
+	/*! \brief Records a span of time on the calling thread.
+	*
+	* \param name The span name. Must be a string literal (or otherwise
+	* outlive the trace), as only the pointer is stored.
+	* \param start When the span started, from `SGB_Clock::GetNanoseconds()`.
+	* \param end When the span ended, from `SGB_Clock::GetNanoseconds()`.
+	*
+	* Does nothing if the tracer is not active.
+	*/
+	static void AddEvent(const char* name, Uint64 start, Uint64 end);
+};
+
+/*! \brief Records a trace event spanning its own lifetime.
+*
+* Use it through `SGB_TRACE_SCOPE()`.
+*/
+class SGB_TraceScope
+{
+public:
+	/*! \brief Starts the span, if the tracer is active. */
+	explicit SGB_TraceScope(const char* name)
+	{
+		_name = SGB_Tracer::IsActive() ? name : NULL;
+		_start = _name != NULL ? SGB_Clock::GetNanoseconds() : 0;
+	}
+
+	/*! \brief Ends the span and records it. */
+	~SGB_TraceScope()
+	{
+		if (_name != NULL)
+		{
+			SGB_Tracer::AddEvent(_name, _start, SGB_Clock::GetNanoseconds());
+		}
+	}
+
+	SGB_TraceScope(const SGB_TraceScope&) = delete;
+	SGB_TraceScope& operator=(const SGB_TraceScope&) = delete;
+
+private:
+	const char* _name;
+	Uint64 _start;
+};
+
+#define SGB_TRACE_CONCAT_(a, b) a##b
+#define SGB_TRACE_CONCAT(a, b) SGB_TRACE_CONCAT_(a, b)
+
+/*! \brief Records a trace event from this point until the end of the
+ * current scope.
+*
+* \param name The span name, must be a string literal.
+*/
+#if SGB_ENABLE_TRACER
+#define SGB_TRACE_SCOPE(name) \
+	SGB_TraceScope SGB_TRACE_CONCAT(_sgbTraceScope, __LINE__)(name)
+#else
+#define SGB_TRACE_SCOPE(name)
+#endif
+
+/*! \brief Names the calling thread on the trace, see
+ * `SGB_Tracer::SetThreadName()`.
+*
+* \param name The thread name, must be a string literal.
+*/
+#if SGB_ENABLE_TRACER
+#define SGB_TRACE_THREAD_NAME(name) SGB_Tracer::SetThreadName(name)
+#else
+#define SGB_TRACE_THREAD_NAME(name)
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+
+/*! \brief Internal class. A lock-free mailbox holding the latest value
+* published by one thread for another one.
+*
+* Uses three slots: one being written by the producer, one being read
+* by the consumer and one holding the latest complete value between
+* them. Publishing and reading never block nor wait for each other,
+* and the consumer always gets the newest value, skipping any value
+* replaced before it looked.
+*
+* Exactly one thread may publish and exactly one (possibly other)
+* thread may read.
+*/
+template <typename T>
+class SGB_TripleBuffer
+{
+public:
+	SGB_TripleBuffer()
+	{
+		back_ = 0;
+		middle_.store(1, std::memory_order_relaxed);
+		front_ = 2;
+	}
+
+	/*! \brief Publishes a new value, replacing any unread one.
+	*
+	* \param item The value to be published.
+	*
+	* Must only be called by the producer thread.
+	*/
+	void publish(const T& item)
+	{
+		buffers_[back_] = item;
+
+		//hands the written slot over, flagged as new, and takes the old middle one
+		back_ = middle_.exchange(back_ | NEW_VALUE, std::memory_order_acq_rel) &
+			INDEX_MASK;
+	}
+
+	/*! \brief Gets the latest value, if one was published since the last call.
+	*
+	* \param[out] item Set to the latest value, when there is a new one.
+	*
+	* \returns <b>true</b> if there was a new value, <b>false</b> otherwise.
+	*
+	* Must only be called by the consumer thread.
+	*/
+	bool read(T& item)
+	{
+		if ((middle_.load(std::memory_order_relaxed) & NEW_VALUE) == 0)
+		{
+			return false;
+		}
+
+		front_ = middle_.exchange(front_, std::memory_order_acq_rel) &
+			INDEX_MASK;
+
+		item = buffers_[front_];
+
+		return true;
+	}
+
+	SGB_TripleBuffer(const SGB_TripleBuffer&) = delete;            // disable copying
+	SGB_TripleBuffer& operator=(const SGB_TripleBuffer&) = delete; // disable assignment
+
+private:
+	static const unsigned INDEX_MASK = 3;
+	static const unsigned NEW_VALUE = 4;
+
+	T buffers_[3];
+
+	//slot being written, only touched by the producer
+	unsigned back_;
+
+	//latest complete slot, plus the NEW_VALUE flag
+	std::atomic<unsigned> middle_;
+
+	//slot being read, only touched by the consumer
+	unsigned front_;
+};
@@ -21,6 +21,40 @@ const int SGB_FAIL = -1;
 #define SGB_LOADING_MESSAGE_SIZE 255
 #endif
 
+/*! \brief Defines how many loading status messages can wait on a `SGB_LoadingQueue` before new ones are dropped */
+#ifndef SGB_LOADING_QUEUE_SIZE
+#define SGB_LOADING_QUEUE_SIZE 256
+#endif
+
+/*! \brief Defines how many tasks a single load can register on a `SGB_LoadingProgress` */
+#ifndef SGB_LOADING_MAX_TASKS
+#define SGB_LOADING_MAX_TASKS 64
+#endif
+
+/*! \brief Defines how many frame durations are kept to calculate `SGB_DisplayFrameStats` */
+#ifndef SGB_FRAME_HISTORY_SIZE
+#define SGB_FRAME_HISTORY_SIZE 600
+#endif
+
+/*! \brief Defines how many SDL_Event's are read from SDL's queue at once */
+#ifndef SGB_EVENT_BATCH_SIZE
+#define SGB_EVENT_BATCH_SIZE 64
+#endif
+
+/*! \brief Defines if the per-phase frame profiler is compiled.
+*
+* When defined as 0, all profiling calls on `SGB_Display::Update()` compile to nothing,
+* regardless of `SGB_DisplayInitInfo::EnableProfiler`, and the loop phases are not sent to `SGB_Tracer`.
+*/
+#ifndef SGB_ENABLE_PROFILER
+#define SGB_ENABLE_PROFILER 1
+#endif
+
+/*! \brief Defines how many frames are kept by the frame profiler */
+#ifndef SGB_PROFILER_HISTORY_SIZE
+#define SGB_PROFILER_HISTORY_SIZE 300
+#endif
+
 /*! \brief Structure defining how a SGB_Display will be initialized.
 
 Example base values:
@@ -119,17 +153,206 @@ public:
 	* Unless changed via SGB_Display::SetDrawColor(), any rendering will use this color as default.
 	*/
 	SDL_Color RendererDefaultDrawColor;
+
+	/*! \brief Indicates if `SGB_Screen::Update()` will be called at a fixed rate, independent of the render rate.
+	*
+	* When set to true, the elapsed time of each loop cycle is accumulated and `SGB_Screen::Update()` is called
+	* once for each whole `1 / FixedUpdateRate` step available, so it can be called zero, one or more times
+	* per loop cycle. `SGB_DisplayLoopStats::DeltaTicks`, `DeltaNanoseconds` and `DeltaSeconds` will then
+	* always hold the fixed step duration.
+	*
+	* The time left on the accumulator is exposed as `SGB_DisplayLoopStats::InterpolationAlpha`, so
+	* `SGB_Screen::Draw()` can interpolate between the last two simulation states.
+	*
+	* Defaults to false.
+	*/
+	bool FixedTimestep = false;
+
+	/*! \brief Defines how many times per second `SGB_Screen::Update()` is called when `FixedTimestep` is set.
+	*
+	* Defaults to 60.
+	*/
+	Uint32 FixedUpdateRate = 60;
+
+	/*! \brief Defines the maximum number of fixed steps run in a single loop cycle when `FixedTimestep` is set.
+	*
+	* If a loop cycle takes too long, the accumulated time would require more and more steps to catch up,
+	* making the next cycle even longer. When more steps than this are needed, the extra time is discarded
+	* and the simulation runs slower than real time instead.
+	*
+	* Defaults to 5.
+	*/
+	Uint32 MaxUpdateStepsPerFrame = 5;
+
+	/*! \brief Indicates if `SGB_Display::Update()` will wait for the next frame instead of returning immediately.
+	*
+	* Without pacing, a locked frame rate only skips the rendering, so the main loop keeps calling
+	* `SGB_Display::Update()` (and `SGB_Screen::Update()`) as fast as it can, using a whole CPU core.
+	*
+	* When set to true, each `SGB_Display::Update()` ends by sleeping until the next frame is due. Most of
+	* the wait is done with `SDL_Delay()` and only the last moments are spent spinning, with the sleep
+	* margin adjusted to how much the OS has been oversleeping, so the frame time is not made less stable.
+	*
+	* Has no effect when the frame rate is unlocked. Defaults to false.
+	*/
+	bool PaceFrames = false;
+
+	/*! \brief Indicates if the time spent on each phase of `SGB_Display::Update()` will be measured.
+	*
+	* The measurements can be read with `SGB_Display::GetFrameProfile()` and
+	* `SGB_Display::GetFrameProfileHistory()`. When disabled, each phase costs a single branch.
+	*
+	* Has no effect if `SGB_ENABLE_PROFILER` is defined as 0. Defaults to false.
+	*/
+	bool EnableProfiler = false;
+
+	/*! \brief Defines a file where Chrome/Perfetto trace events will be recorded.
+	*
+	* If set, `SGB_Display::Init()` starts `SGB_Tracer` with this path and the SGB_Display destructor stops it.
+	* Use NULL to not record a trace. Defaults to NULL.
+	*/
+	const char* TraceFilePath = NULL;
+
+	/*! \brief Indicates if the frame rate settings will be adjusted while the SGB_Display runs.
+	*
+	* Without it, the battery check for `UnlockFrameRate` is done only once on `SGB_Display::Init()`.
+	*
+	* When set to true, the power state is checked every `PowerCheckInterval` milliseconds, so unplugging
+	* the device locks the frame rate (unless `UnlockFrameRateOnBattery` is set) and applies `BatteryFrameRate`,
+	* and plugging it back restores the original settings.
+	*
+	* The rendered frames are also watched: if too many of them miss their deadline, the target frame rate is
+	* lowered (down to `MinimumFrameRate`) and, after enough stable time, raised back (up to `TargetFrameRate`).
+	*
+	* The frame rate in use is reported by `SGB_DisplayLoopStats::EffectiveFrameRate`. Defaults to false.
+	*/
+	bool AdaptiveFrameRate = false;
+
+	/*! \brief Defines the lowest frame rate `AdaptiveFrameRate` can set. Defaults to 30. */
+	Uint32 MinimumFrameRate = 30;
+
+	/*! \brief Defines the highest frame rate `AdaptiveFrameRate` can set while running on battery.
+	*
+	* Use 0 to keep `TargetFrameRate` on battery. Defaults to 0.
+	*/
+	Uint32 BatteryFrameRate = 0;
+
+	/*! \brief Defines how often (in milliseconds) `AdaptiveFrameRate` checks the power state. Defaults to 5000. */
+	Uint32 PowerCheckInterval = 5000;
+
+	/*! \brief Indicates if the SGB_Display will run without any window.
+	*
+	* When set to true, SDL's "dummy" video driver is used (unless `SDL_VIDEODRIVER` is already set) and, instead of a SDL_Window, a software SDL_Renderer
+	* draws to an offscreen SDL_Surface of `WindowDefaultWidth` by `WindowDefaultHeight` pixels (see
+	* `SGB_Display::GetFramebuffer()`). The loop, timing and loading work exactly as they do with a window,
+	* making it possible to run screens on CI and servers, for example to track performance.
+	*
+	* The window, renderer index/flags and VSync fields are ignored. If SDL's video subsystem was already
+	* started by the application, it must have been started with the dummy driver. Defaults to false.
+	*/
+	bool Headless = false;
+
+	/*! \brief Defines how many worker threads the `SGB_Display`'s SGB_JobSystem will have.
+	*
+	* The job system lets `SGB_Screen::LoadScreen()` (and any other code) split work across every core. When
+	* set to 0, one less than the number of CPU cores is used, as the threads waiting for jobs also run them.
+	* Defaults to 0.
+	*/
+	Uint32 JobWorkerCount = 0;
+
+	/*! \brief Indicates if the previous `SGB_Screen` is unloaded only after the next one is shown.
+	*
+	* By default a transition unloads the previous screen before loading the next one, making the user wait
+	* for both. When set to true, the next screen is loaded first and the previous one is unloaded and deleted
+	* on the loading thread after the switch, as long as both fit on `ScreenMemoryBudget` (see
+	* `SGB_Screen::GetMemoryUsage()`). The overlap is reported by `SGB_Display::GetLoadingStats()`.
+	* Defaults to false.
+	*/
+	bool DeferScreenUnload = false;
+
+	/*! \brief Defines how many bytes two `SGB_Screen`'s can use together while a deferred unload overlaps them.
+	*
+	* When the previous screen's usage plus the next screen's expected usage goes over it, the transition falls
+	* back to unloading first. When set to 0, there is no limit. Defaults to 0.
+	*/
+	Uint64 ScreenMemoryBudget = 0;
+
+	/*! \brief Defines how many bytes the `SGB_Screen`'s kept loaded on the screen cache can use together.
+	*
+	* When greater than 0, outgoing screens with a `SGB_Screen::GetScreenName()` are not unloaded: after
+	* `SGB_Screen::ScreenFinish()` they are kept, still loaded, on a cache. Setting a new screen with the same
+	* name reactivates the cached instance with just `SGB_Screen::ScreenShow()`, on the next loop cycle. The least
+	* recently used screens are unloaded when the `SGB_Screen::GetMemoryUsage()` sum goes over this budget.
+	* Defaults to 0 (no cache).
+	*/
+	Uint64 ScreenCacheBudget = 0;
+
+	/*! \brief Defines how many `SGB_Screen`'s the screen cache can hold, regardless of their memory usage.
+	*
+	* Only used when `ScreenCacheBudget` is greater than 0. Defaults to 4.
+	*/
+	Uint32 ScreenCacheMaxScreens = 4;
+
+	/*! \brief Defines how long, in microseconds, each `SGB_Display::Update()` may spend creating textures queued
+	* with `SGB_Screen::QueueTextureUpload()`.
+	*
+	* At least one texture is created per loop cycle, even if it alone goes over the budget. Defaults to 2000 (2 ms).
+	*/
+	Uint32 TextureUploadBudget = 2000;
+
+	/*! \brief Defines the file where the duration of each screen load is kept, to estimate the next ones
+	* (see `SGB_LoadingProgress`).
+	*
+	* If NULL, durations are only remembered while the game is running. Defaults to NULL.
+	*/
+	const char* LoadingHistoryPath = NULL;
+
+	/*! \brief Indicates if the SGB_Screen rectangle helpers (e.g. `SGB_Screen::FillRect()`) are recorded on a
+	* `SGB_DrawBatch` and rendered grouped by color, instead of right away.
+	*
+	* Rectangles with different colors may be reordered, see `SGB_Screen::FlushDraws()`. Defaults to false.
+	*/
+	bool BatchDraws = false;
+
+	/*! \brief Defines how long, in milliseconds, a resource released by every SGB_Screen stays loaded on the
+	* `SGB_ResourceManager`, to be reused if a following screen asks for it.
+	*
+	* Defaults to 10000 (10 seconds).
+	*/
+	Uint32 ResourceUnloadDelay = 10000;
+
+	/*! \brief Defines how many bytes the released resources may keep loaded on the `SGB_ResourceManager` before
+	* the least recently released are unloaded, even within `ResourceUnloadDelay`.
+	*
+	* If 0, only `ResourceUnloadDelay` is considered. Defaults to 0.
+	*/
+	Uint64 ResourceCacheBudget = 0;
+
+	/*! \brief Indicates if a frame is only rendered when something was invalidated with
+	* `SGB_Screen::Invalidate()` (or `SGB_Display::Invalidate()`).
+	*
+	* A new current SGB_Screen and window events invalidate the whole frame. Loop cycles with nothing to render
+	* sleep until the next frame is due, even if `PaceFrames` is not set or the frame rate is unlocked.
+	* Defaults to false.
+	*/
+	bool RenderOnChange = false;
 };
 
 /*! \brief Structure used to hold information related to the current loop cycle of a `SGB_Display` .*/
 struct SGB_DisplayLoopStats {
 public:
-	/*! \brief Stores how much time has passed since the SGB_Display initialization */
+	/*! \brief Stores how much time has passed since the SGB_Display initialization
+	*
+	* Kept for compatibility: being a 32 bits millisecond counter, it wraps around after about 49 days.
+	* Prefer `TotalNanoseconds` for long running applications.
+	*/
 	Uint32 TotalTicks;
 
 	/*! \brief Stores how many ticks has passed since the last loop cycle.
 	*
 	* Use this value when calculations based on miliseconds passed are needed.
+	*
+	* The value is truncated to whole milliseconds, use `DeltaNanoseconds` when precision matters.
 	*/
 	Uint32 DeltaTicks;
 
@@ -137,12 +360,158 @@ public:
 	*
 	* Normally this value will be less than 1 second (< 1.0f).
 	* Use this value when "something per second" calculations are needed.
+	*
+	* Calculated from `DeltaNanoseconds`, so it is not limited to millisecond precision.
 	*/
 	float DeltaSeconds;
 
+	/*! \brief Stores how many nanoseconds has passed since the SGB_Display initialization.
+	*
+	* Measured with `SDL_GetPerformanceCounter()`.
+	*/
+	Uint64 TotalNanoseconds;
+
+	/*! \brief Stores how many nanoseconds has passed since the last loop cycle.
+	*
+	* Measured with `SDL_GetPerformanceCounter()`.
+	*/
+	Uint64 DeltaNanoseconds;
+
 	/*! \brief Stores the last calculated average frame rate*/
 	Uint32 AverageFrameRate;
 
+	/*! \brief Stores the frame rate currently being targeted.
+	*
+	* Equal to `SGB_DisplayInitInfo::TargetFrameRate` unless `SGB_DisplayInitInfo::AdaptiveFrameRate`
+	* changed it.
+	*/
+	Uint32 EffectiveFrameRate;
+
+	/*! \brief Indicates if the frame rate is currently unlocked.
+	*
+	* Depends on `SGB_DisplayInitInfo::UnlockFrameRate` and on the power state.
+	*/
+	bool FrameRateUnlocked;
+
+	/*! \brief Stores how many times `SGB_Screen::Update()` was called on the current loop cycle.
+	*
+	* Always 1 unless `SGB_DisplayInitInfo::FixedTimestep` is set.
+	*/
+	Uint32 UpdateSteps;
+
+	/*! \brief Stores how far the simulation is between the last fixed step and the next one.
+	*
+	* A value from 0.0 to 1.0, only meaningful when `SGB_DisplayInitInfo::FixedTimestep` is set
+	* (otherwise it is always 1.0). Use it on `SGB_Screen::Draw()` to blend the previous and current states:
+	* \code{.cpp}
+	*     float x = previousX + (currentX - previousX) * stats.InterpolationAlpha;
+	* \endcode
+	*/
+	float InterpolationAlpha;
+
+};
+
+/*! \brief Structure holding the frame time distribution of the last rendered frames of a `SGB_Display`.
+*
+* Calculated over the last `SGB_FRAME_HISTORY_SIZE` rendered frames. Unlike the average frame rate,
+* the percentiles and the 1% low expose occasional long frames (hitches).
+*
+* All frame times are in milliseconds.
+*/
+struct SGB_DisplayFrameStats {
+public:
+	/*! \brief Stores how many frames were used on the calculation */
+	Uint32 SampleCount;
+
+	/*! \brief Stores the average frame time */
+	float AverageFrameTime;
+
+	/*! \brief Stores the median frame time (half of the frames took at most this long) */
+	float FrameTimeP50;
+
+	/*! \brief Stores the 95th percentile frame time (95% of the frames took at most this long) */
+	float FrameTimeP95;
+
+	/*! \brief Stores the 99th percentile frame time (99% of the frames took at most this long) */
+	float FrameTimeP99;
+
+	/*! \brief Stores the longest frame time */
+	float MaxFrameTime;
+
+	/*! \brief Stores the frame rate calculated only with the slowest 1% of the frames */
+	float OnePercentLowFPS;
+};
+
+/*! \brief Structure holding information about the `SGB_Screen` transitions of a `SGB_Display`.
+*
+* Memory values are the sum of the `SGB_Screen::GetMemoryUsage()` of both screens, in bytes.
+*/
+struct SGB_DisplayLoadingStats {
+public:
+	/*! \brief Stores how many transitions unloaded the previous screen after showing the next one */
+	Uint32 DeferredUnloads;
+
+	/*! \brief Stores how many transitions unloaded the previous screen before loading the next one */
+	Uint32 SerialUnloads;
+
+	/*! \brief Stores the memory used by both screens at the moment of the last deferred unload */
+	Uint64 LastOverlapMemory;
+
+	/*! \brief Stores the highest memory used by both screens on a deferred unload */
+	Uint64 PeakOverlapMemory;
+};
+
+/*! \brief Identifies each phase of a `SGB_Display::Update()` call measured by the frame profiler. */
+enum SGB_FramePhase
+{
+	/*! \brief The loading manager update, including screen transitions */
+	SGB_FRAME_PHASE_LOADING = 0,
+
+	/*! \brief All `SGB_Screen::Update()` calls of the loop cycle */
+	SGB_FRAME_PHASE_UPDATE,
+
+	/*! \brief Filling the renderer with the background color */
+	SGB_FRAME_PHASE_CLEAR,
+
+	/*! \brief `SGB_Display::BeginDraw()` */
+	SGB_FRAME_PHASE_BEGIN_DRAW,
+
+	/*! \brief `SGB_Screen::Draw()` */
+	SGB_FRAME_PHASE_DRAW,
+
+	/*! \brief `SGB_Display::EndDraw()` */
+	SGB_FRAME_PHASE_END_DRAW,
+
+	/*! \brief `SDL_RenderPresent()` */
+	SGB_FRAME_PHASE_PRESENT,
+
+	/*! \brief Polling and handling the SDL events */
+	SGB_FRAME_PHASE_EVENTS,
+
+	/*! \brief Creating the textures queued by the screens (see `SGB_DisplayInitInfo::TextureUploadBudget`) */
+	SGB_FRAME_PHASE_UPLOAD,
+
+	/*! \brief Waiting for the next frame (see `SGB_DisplayInitInfo::PaceFrames`) */
+	SGB_FRAME_PHASE_WAIT,
+
+	/*! \brief How many phases there are. Not a phase itself. */
+	SGB_FRAME_PHASE_COUNT
+};
+
+/*! \brief Structure holding how long each phase of a single `SGB_Display::Update()` call took. */
+struct SGB_FrameProfile {
+public:
+	/*! \brief Stores when the loop cycle started, in nanoseconds since the SGB_Display initialization */
+	Uint64 StartNanoseconds;
+
+	/*! \brief Stores how long the whole loop cycle took, in nanoseconds */
+	Uint64 TotalNanoseconds;
+
+	/*! \brief Stores how long each phase took, in nanoseconds, indexed by `SGB_FramePhase`.
+	*
+	* Phases that did not happen on the loop cycle (like drawing, when the frame was not rendered) are 0.
+	*/
+	Uint64 PhaseNanoseconds[SGB_FRAME_PHASE_COUNT];
 };
 
 /*! \brief Structure to send the status of the loading process to an running SGB_LoadingScreen instance.
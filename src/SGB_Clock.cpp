@@ -0,0 +1,11 @@
+#include "SGB_Clock.h"
+
+Uint64 SGB_Clock::GetNanoseconds()
+{
+	Uint64 counter = SDL_GetPerformanceCounter();
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+
+	//split the conversion so counter * 10^9 does not overflow
+	return (counter / frequency) * SGB_NANOSECONDS_PER_SECOND +
+		((counter % frequency) * SGB_NANOSECONDS_PER_SECOND) / frequency;
+}
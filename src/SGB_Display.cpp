@@ -9,6 +9,16 @@ SGB_Display::SGB_Display()
 {
 	_window = NULL;
 	_renderer = NULL;
+	_framebuffer = NULL;
+	_renderTarget = NULL;
+	_blendMode = SDL_BLENDMODE_NONE;
+	_drawColor = { 0, 0, 0, 0 };
+
+	//the first frame is always rendered
+	_dirty = true;
+	_partiallyDirty = false;
+	_dirtyRect = { 0, 0, 0, 0 };
+	_renderedScreen = NULL;
 
 	_loadingManager.SetOwner(this);
 
@@ -17,8 +27,41 @@ SGB_Display::SGB_Display()
 
 SGB_Display::~SGB_Display()
 {
+	//screens release their resources while unloading, which may hold
+	//textures of the renderer, so they go before it
+	_loadingManager.Shutdown();
+
+	//textures that will never be needed
+	while (!_textureUploads.empty())
+	{
+		SDL_FreeSurface(_textureUploads.pop().surface);
+	}
+
+	_resourceManager.Clear();
+
+	//anything left would be unloaded after the renderer is destroyed
+	if (_resourceManager.GetResourceCount() > 0)
+	{
+		SDL_Log("SGB: %u resources still referenced after the screens were deleted",
+			_resourceManager.GetResourceCount());
+	}
+
+	if (_initInfo.TraceFilePath != NULL)
+	{
+		SGB_Tracer::Stop();
+	}
+
 	SDL_DestroyRenderer(_renderer);
-	SDL_DestroyWindow(_window);
+
+	if (_window != NULL)
+	{
+		SDL_DestroyWindow(_window);
+	}
+
+	if (_framebuffer != NULL)
+	{
+		SDL_FreeSurface(_framebuffer);
+	}
 
 	if (_initInfo.HandleSDLStartupAndFinish)
 	{
@@ -30,6 +73,8 @@ int SGB_Display::Init()
 {
 	BeforeInit();
 
+	_initInfo = GetInitInfo();
+
 	if (_initInfo.HandleSDLStartupAndFinish)
 	{
 		if (SDL_Init(0))
@@ -38,6 +83,13 @@ int SGB_Display::Init()
 		}
 	}
 
+	if (_initInfo.Headless)
+	{
+		//must be set before the video subsystem starts, keeping a
+		//driver chosen by the user
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	}
+
 	if (SDL_WasInit(SDL_INIT_VIDEO) == 0)
 	{
 		if (SDL_InitSubSystem(SDL_INIT_VIDEO))
@@ -54,8 +106,82 @@ int SGB_Display::Init()
 		}
 	}
 
-	_initInfo = GetInitInfo();
+	//checking battery status (the adaptive frame rate keeps checking it)
+	if (_initInfo.UnlockFrameRate && !_initInfo.AdaptiveFrameRate &&
+		IsRunningOnBattery() && !_initInfo.UnlockFrameRateOnBattery)
+	{
+		_initInfo.UnlockFrameRate = false;
+	}
+
+	if (_initInfo.Headless)
+	{
+		if (CreateHeadlessRenderer())
+		{
+			return SGB_FAIL;
+		}
+	}
+	else if (CreateWindowRenderer())
+	{
+		return SGB_FAIL;
+	}
+
+	SyncRenderState();
 
+	if (SetBlendMode(_initInfo.RendererBlendMode))
+	{
+		return SGB_FAIL;
+	}
+
+	_drawBatch.SetDisplay(this);
+
+	if (_initInfo.FrameRateSamplesPerSecond < 1)
+	{
+		_initInfo.FrameRateSamplesPerSecond = 1;
+	}
+
+	if (_initInfo.FixedUpdateRate < 1)
+	{
+		_initInfo.FixedUpdateRate = 1;
+	}
+
+	_timingManager.Setup(_initInfo);
+
+	if (_jobSystem.Start(_initInfo.JobWorkerCount))
+	{
+		return SGB_FAIL;
+	}
+
+	_resourceManager.Setup(_initInfo);
+
+	_loadingManager.Setup(_initInfo);
+
+	if (_loadingManager.Start())
+	{
+		return SGB_FAIL;
+	}
+
+	AfterInit();
+
+	_loopStats.TotalTicks = _timingManager.StartGlobalTimer();
+	_loopStats.TotalNanoseconds = _timingManager.GetGlobalNanoseconds();
+
+	_profiler.Setup(_initInfo, SGB_Clock::GetNanoseconds());
+
+	SGB_TRACE_THREAD_NAME("SGB_MainThread");
+
+	if (_initInfo.TraceFilePath != NULL)
+	{
+		if (SGB_Tracer::Start(_initInfo.TraceFilePath))
+		{
+			return SGB_FAIL;
+		}
+	}
+
+	return SGB_SUCCESS;
+}
+
+int SGB_Display::CreateWindowRenderer()
+{
 	Uint32 windowFlags = SDL_WINDOW_SHOWN;
 
 	if (_initInfo.BorderlessWindow)
@@ -82,12 +208,6 @@ int SGB_Display::Init()
 		return SGB_FAIL;
 	}
 
-	//checking battery status
-	if (_initInfo.UnlockFrameRate && IsRunningOnBattery() && !_initInfo.UnlockFrameRateOnBattery)
-	{
-		_initInfo.UnlockFrameRate = false;
-	}
-
 	if (_initInfo.EnableVSync)
 	{
 		_initInfo.RendererFlags = _initInfo.RendererFlags | SDL_RENDERER_PRESENTVSYNC;
@@ -100,58 +220,169 @@ int SGB_Display::Init()
 		return SGB_FAIL;
 	}
 
-	if (SDL_SetRenderDrawBlendMode(_renderer, _initInfo.RendererBlendMode))
+	return SGB_SUCCESS;
+}
+
+int SGB_Display::CreateHeadlessRenderer()
+{
+	_framebuffer = SDL_CreateRGBSurfaceWithFormat(
+		0,
+		_initInfo.WindowDefaultWidth,
+		_initInfo.WindowDefaultHeight,
+		32,
+		SDL_PIXELFORMAT_ARGB8888);
+
+	if (_framebuffer == NULL)
 	{
 		return SGB_FAIL;
 	}
 
-	if (_initInfo.FrameRateSamplesPerSecond < 1)
+	_renderer = SDL_CreateSoftwareRenderer(_framebuffer);
+
+	if (_renderer == NULL)
 	{
-		_initInfo.FrameRateSamplesPerSecond = 1;
+		return SGB_FAIL;
 	}
 
-	_timingManager.Setup(_initInfo);
-
-	AfterInit();
-
-	_loopStats.TotalTicks = _timingManager.StartGlobalTimer();
-
 	return SGB_SUCCESS;
 }
 
 void SGB_Display::Update()
 {
+	_profiler.BeginFrame();
+
+	_profiler.BeginPhase(SGB_FRAME_PHASE_LOADING);
 	_loadingManager.Update();
+	_resourceManager.Update();
+	_profiler.EndPhase(SGB_FRAME_PHASE_LOADING);
+
+	_profiler.BeginPhase(SGB_FRAME_PHASE_UPLOAD);
+	UploadTextures();
+	_profiler.EndPhase(SGB_FRAME_PHASE_UPLOAD);
 	
 	auto screen = _loadingManager.GetCurrentScreen(); 
 
+	_profiler.BeginPhase(SGB_FRAME_PHASE_EVENTS);
+	HandleEvents(screen);
+	_profiler.EndPhase(SGB_FRAME_PHASE_EVENTS);
+
 	UpdateScreen(screen);
-	RenderScreen(screen);
 
-	SDL_Event _displayEvent;
+	auto rendered = RenderScreen(screen);
+
+	//without a present blocking on vsync, an idle loop would spin
+	_profiler.BeginPhase(SGB_FRAME_PHASE_WAIT);
+	_timingManager.WaitForNextFrame(_initInfo.RenderOnChange && !rendered);
+	_profiler.EndPhase(SGB_FRAME_PHASE_WAIT);
+
+	_profiler.EndFrame();
+}
+
+SDL_Window* SGB_Display::GetWindow()
+{
+	return _window;
+}
+
+SDL_Renderer* SGB_Display::GetRenderer()
+{
+	return _renderer;
+}
+
+SDL_Surface* SGB_Display::GetFramebuffer()
+{
+	return _framebuffer;
+}
+
+void SGB_Display::SetTimeSource(SGB_TimeSource* timeSource)
+{
+	_timingManager.SetTimeSource(timeSource);
+}
+
+SGB_JobSystem* SGB_Display::GetJobSystem()
+{
+	return &_jobSystem;
+}
+
+SGB_ResourceManager* SGB_Display::GetResourceManager()
+{
+	return &_resourceManager;
+}
+
+void SGB_Display::QueueTextureUpload(SGB_Screen* owner, SDL_Surface* surface,
+	SDL_Texture** texture)
+{
+	SGB_TextureUpload upload = { owner, surface, texture };
+
+	_textureUploads.push(upload);
+}
 
-	if (SDL_PollEvent(&_displayEvent))
+void SGB_Display::DiscardTextureUploads(SGB_Screen* owner)
+{
+	std::vector<SGB_TextureUpload> kept;
+
+	//this is the only consumer, so only new uploads can show up meanwhile
+	while (!_textureUploads.empty())
 	{
-		if (_displayEvent.type == SDL_QUIT)
+		auto upload = _textureUploads.pop();
+
+		if (upload.owner == owner)
 		{
-			StopRunning();
+			SDL_FreeSurface(upload.surface);
+			owner->FinishTextureUpload();
 		}
-
-		if (IsRunning())
+		else
 		{
-			SDL_PushEvent(&_displayEvent);
+			kept.push_back(upload);
 		}
 	}
+
+	for (auto& upload : kept)
+	{
+		_textureUploads.push(upload);
+	}
 }
 
-SDL_Window* SGB_Display::GetWindow()
+void SGB_Display::UploadTextures()
 {
-	return _window;
+	if (_textureUploads.empty())
+	{
+		return;
+	}
+
+	Uint64 deadline = SGB_Clock::GetNanoseconds() +
+		_initInfo.TextureUploadBudget * (SGB_NANOSECONDS_PER_TICK / 1000);
+
+	//this is the only consumer, so the queue can't be emptied meanwhile
+	do
+	{
+		auto upload = _textureUploads.pop();
+
+		*upload.texture = SDL_CreateTextureFromSurface(
+			_renderer, upload.surface);
+
+		if (*upload.texture == NULL)
+		{
+			SDL_Log("SGB: texture upload failed: %s", SDL_GetError());
+		}
+
+		SDL_FreeSurface(upload.surface);
+
+		if (upload.owner->FinishTextureUpload())
+		{
+			upload.owner->TexturesReady();
+		}
+	} while (!_textureUploads.empty() &&
+		SGB_Clock::GetNanoseconds() < deadline);
 }
 
-SDL_Renderer* SGB_Display::GetRenderer()
+int SGB_Display::ReadPixels(void* pixels, int pitch, Uint32 format)
 {
-	return _renderer;
+	if (SDL_RenderReadPixels(_renderer, NULL, format, pixels, pitch))
+	{
+		return SGB_FAIL;
+	}
+
+	return SGB_SUCCESS;
 }
 
 void SGB_Display::SetScreen(SGB_Screen* screen)
@@ -159,6 +390,16 @@ void SGB_Display::SetScreen(SGB_Screen* screen)
 	_loadingManager.SetScreen(screen);
 }
 
+void SGB_Display::PreloadScreen(SGB_Screen* screen)
+{
+	_loadingManager.PreloadScreen(screen);
+}
+
+bool SGB_Display::IsScreenCached(const char* name)
+{
+	return _loadingManager.FindCachedScreen(name) != NULL;
+}
+
 void SGB_Display::SetLoadingScreen(SGB_Screen* screen)
 {
 	_loadingManager.SetLoadingScreen(screen);
@@ -183,31 +424,184 @@ void SGB_Display::UpdateScreen(SGB_Screen* screen)
 	
 	_loopStats.TotalTicks = _timingManager.GetGlobalTicks();
 	_loopStats.DeltaTicks = _timingManager.GetDeltaTicks();
+	_loopStats.TotalNanoseconds = _timingManager.GetGlobalNanoseconds();
+	_loopStats.DeltaNanoseconds = _timingManager.GetDeltaNanoseconds();
+	_loopStats.EffectiveFrameRate = _timingManager.GetEffectiveFrameRate();
+	_loopStats.FrameRateUnlocked = _timingManager.IsFrameRateUnlocked();
+	_loopStats.UpdateSteps = 1;
+	_loopStats.InterpolationAlpha = 1.f;
+
+	if (_initInfo.FixedTimestep)
+	{
+		//each step sees the same, fixed, delta time
+		_loopStats.UpdateSteps = _timingManager.ConsumeFixedSteps();
+		_loopStats.DeltaTicks = _timingManager.GetFixedStepTicks();
+		_loopStats.DeltaNanoseconds =
+			_timingManager.GetFixedStepNanoseconds();
+		_loopStats.InterpolationAlpha =
+			_timingManager.GetInterpolationAlpha();
+	}
 
-	_loopStats.DeltaSeconds = 
-		static_cast<float>(_loopStats.DeltaTicks) / 1000.f;
+	_loopStats.DeltaSeconds = static_cast<float>(
+		static_cast<double>(_loopStats.DeltaNanoseconds) /
+		SGB_NANOSECONDS_PER_SECOND);
 
 	if (screen != NULL)
 	{
-		screen->Update();
+		_profiler.BeginPhase(SGB_FRAME_PHASE_UPDATE);
+
+		for (Uint32 step = 0; step < _loopStats.UpdateSteps; ++step)
+		{
+			screen->Update();
+		}
+
+		_profiler.EndPhase(SGB_FRAME_PHASE_UPDATE);
+	}
+}
+
+void SGB_Display::HandleEvents(SGB_Screen* screen)
+{
+	SDL_PumpEvents();
+
+	_events.clear();
+
+	int count = 0;
+
+	//drain SDL's queue in batches, without pumping it again
+	do
+	{
+		auto offset = _events.size();
+
+		_events.resize(offset + SGB_EVENT_BATCH_SIZE);
+
+		count = SDL_PeepEvents(
+			&_events[offset],
+			SGB_EVENT_BATCH_SIZE,
+			SDL_GETEVENT,
+			SDL_FIRSTEVENT,
+			SDL_LASTEVENT);
+
+		_events.resize(offset + std::max(count, 0));
+	} while (count == SGB_EVENT_BATCH_SIZE);
+
+	for (auto& event : _events)
+	{
+		if (event.type == SDL_QUIT)
+		{
+			StopRunning();
+		}
+		else if (event.type == SDL_WINDOWEVENT)
+		{
+			//exposed, resized, restored...
+			Invalidate();
+		}
+	}
+
+	if (screen != NULL && !_events.empty())
+	{
+		screen->HandleEvents(_events);
 	}
 }
 
-void SGB_Display::RenderScreen(SGB_Screen* screen)
+bool SGB_Display::RenderScreen(SGB_Screen* screen)
 {
+	if (screen != _renderedScreen)
+	{
+		_renderedScreen = screen;
+		Invalidate();
+	}
+
 	if(_timingManager.CanRender())
 	{
-		Clear();
+		if (_initInfo.RenderOnChange && !_dirty)
+		{
+			return false;
+		}
+
+		//only the headless framebuffer still holds the previous frame
+		auto partial = _initInfo.RenderOnChange && _partiallyDirty &&
+			_framebuffer != NULL;
+		auto region = _dirtyRect;
+
+		//invalidated while drawing means the next frame
+		_dirty = false;
+		_partiallyDirty = false;
+
+		_timingManager.RecordRenderedFrame();
+
+		_profiler.BeginPhase(SGB_FRAME_PHASE_CLEAR);
+		if (partial)
+		{
+			SDL_RenderSetClipRect(_renderer, &region);
+			Clear(&region);
+		}
+		else
+		{
+			Clear();
+		}
+		_profiler.EndPhase(SGB_FRAME_PHASE_CLEAR);
 		
 		//Note that the time information is NOT updated in each call
+		_profiler.BeginPhase(SGB_FRAME_PHASE_BEGIN_DRAW);
 		BeginDraw();
+		_profiler.EndPhase(SGB_FRAME_PHASE_BEGIN_DRAW);
 		
+		_profiler.BeginPhase(SGB_FRAME_PHASE_DRAW);
 		if(screen != NULL) screen->Draw();
+		_drawBatch.Flush();
+		_profiler.EndPhase(SGB_FRAME_PHASE_DRAW);
 		
+		_profiler.BeginPhase(SGB_FRAME_PHASE_END_DRAW);
 		EndDraw();
+		_drawBatch.Flush();
+		_profiler.EndPhase(SGB_FRAME_PHASE_END_DRAW);
+
+		if (partial)
+		{
+			SDL_RenderSetClipRect(_renderer, NULL);
+		}
+
+		BeforePresent();
 		
+		_profiler.BeginPhase(SGB_FRAME_PHASE_PRESENT);
 		SDL_RenderPresent(_renderer);
+		_profiler.EndPhase(SGB_FRAME_PHASE_PRESENT);
+
+		return true;
+	}
+
+	return false;
+}
+
+void SGB_Display::Invalidate()
+{
+	_dirty = true;
+	_partiallyDirty = false;
+}
+
+void SGB_Display::Invalidate(SDL_Rect rect)
+{
+	if (!_dirty)
+	{
+		_dirtyRect = rect;
+		_partiallyDirty = true;
 	}
+	else if (_partiallyDirty)
+	{
+		SDL_UnionRect(&_dirtyRect, &rect, &_dirtyRect);
+	}
+
+	_dirty = true;
+}
+
+bool SGB_Display::IsDirty()
+{
+	return _dirty;
+}
+
+SGB_DrawBatch* SGB_Display::GetDrawBatch()
+{
+	return _initInfo.BatchDraws ? &_drawBatch : NULL;
 }
 
 void SGB_Display::ResetDrawColor()
@@ -217,25 +611,85 @@ void SGB_Display::ResetDrawColor()
 
 void SGB_Display::SetDrawColor(SDL_Color color)
 {
-	SDL_SetRenderDrawColor(
+	if (color.r == _drawColor.r &&
+		color.g == _drawColor.g &&
+		color.b == _drawColor.b &&
+		color.a == _drawColor.a)
+	{
+		return;
+	}
+
+	if (SDL_SetRenderDrawColor(
 		_renderer,
 		color.r,
 		color.g,
 		color.b,
-		color.a);
+		color.a) == 0)
+	{
+		_drawColor = color;
+	}
 }
 
 SDL_Color SGB_Display::GetDrawColor()
 {
-	SDL_Color color;
+	return _drawColor;
+}
+
+int SGB_Display::SetBlendMode(SDL_BlendMode blendMode)
+{
+	if (blendMode == _blendMode)
+	{
+		return SGB_SUCCESS;
+	}
+
+	if (SDL_SetRenderDrawBlendMode(_renderer, blendMode))
+	{
+		return SGB_FAIL;
+	}
+
+	_blendMode = blendMode;
+
+	return SGB_SUCCESS;
+}
+
+SDL_BlendMode SGB_Display::GetBlendMode()
+{
+	return _blendMode;
+}
+
+int SGB_Display::SetRenderTarget(SDL_Texture* target)
+{
+	if (target == _renderTarget)
+	{
+		return SGB_SUCCESS;
+	}
+
+	if (SDL_SetRenderTarget(_renderer, target))
+	{
+		return SGB_FAIL;
+	}
+
+	_renderTarget = target;
+
+	return SGB_SUCCESS;
+}
+
+SDL_Texture* SGB_Display::GetRenderTarget()
+{
+	return _renderTarget;
+}
 
+void SGB_Display::SyncRenderState()
+{
 	SDL_GetRenderDrawColor(_renderer,
-		&color.r,
-		&color.g,
-		&color.b,
-		&color.a);
+		&_drawColor.r,
+		&_drawColor.g,
+		&_drawColor.b,
+		&_drawColor.a);
+
+	SDL_GetRenderDrawBlendMode(_renderer, &_blendMode);
 
-	return color;
+	_renderTarget = SDL_GetRenderTarget(_renderer);
 }
 
 SGB_DisplayInitInfo SGB_Display::GetDisplayInitInfo()
@@ -248,11 +702,49 @@ SGB_DisplayLoopStats SGB_Display::GetLoopStats()
 	return _loopStats;
 }
 
-void SGB_Display::Clear()
+SGB_DisplayLoadingStats SGB_Display::GetLoadingStats()
+{
+	return _loadingManager.GetLoadingStats();
+}
+
+SGB_LoadingProgress* SGB_Display::GetLoadingProgress()
+{
+	return _loadingManager.GetLoadingProgress();
+}
+
+SGB_DisplayFrameStats SGB_Display::GetFrameStats()
+{
+	return _timingManager.CalculateFrameStats();
+}
+
+SGB_FrameProfile SGB_Display::GetFrameProfile()
+{
+	return _profiler.GetLastFrame();
+}
+
+void SGB_Display::GetFrameProfileHistory(
+	std::vector<SGB_FrameProfile>& history)
+{
+	_profiler.GetHistory(history);
+}
+
+void SGB_Display::Clear(const SDL_Rect* region)
 {
 	SetDrawColor(_initInfo.RendererBackgroundColor);
 
-	SDL_RenderClear(_renderer);
+	if (region != NULL)
+	{
+		//SDL_RenderClear() ignores the clip rectangle, so the area is overwritten instead
+		auto blendMode = GetBlendMode();
+
+		SetBlendMode(SDL_BLENDMODE_NONE);
+		SDL_RenderFillRect(_renderer, region);
+		SetBlendMode(blendMode);
+	}
+	else
+	{
+		SDL_RenderClear(_renderer);
+	}
 
 	ResetDrawColor();
 }
@@ -0,0 +1,190 @@
+#include "SGB_DisplayFrameRateGovernor.h"
+
+#include <algorithm>
+
+#include "SGB_Clock.h"
+
+//How long each missed deadline evaluation window lasts
+const Uint64 SGB_GOVERNOR_WINDOW = SGB_NANOSECONDS_PER_SECOND;
+
+//Ratio of missed deadlines (in percent) to consider a window bad or good
+const Uint32 SGB_GOVERNOR_BAD_RATIO = 10;
+const Uint32 SGB_GOVERNOR_GOOD_RATIO = 1;
+
+//Hysteresis: consecutive windows needed to step down or up
+const Uint32 SGB_GOVERNOR_BAD_WINDOWS = 2;
+const Uint32 SGB_GOVERNOR_GOOD_WINDOWS = 5;
+
+SGB_DisplayFrameRateGovernor::SGB_DisplayFrameRateGovernor()
+{
+	_enabled = false;
+	_onBattery = false;
+	_unlocked = false;
+	_frameRateCap = 0;
+	_effectiveFrameRate = 0;
+	_nextPowerCheck = 0;
+	_windowStart = 0;
+	_windowFrames = 0;
+	_windowMisses = 0;
+	_badWindows = 0;
+	_goodWindows = 0;
+}
+
+void SGB_DisplayFrameRateGovernor::Setup(SGB_DisplayInitInfo info, Uint64 now)
+{
+	_initInfo = info;
+	_enabled = info.AdaptiveFrameRate;
+
+	_initInfo.MinimumFrameRate = std::max(
+		std::min(_initInfo.MinimumFrameRate, _initInfo.TargetFrameRate),
+		(Uint32)1);
+
+	_unlocked = _initInfo.UnlockFrameRate;
+	_frameRateCap = _initInfo.TargetFrameRate;
+	_effectiveFrameRate = _initInfo.TargetFrameRate;
+
+	_windowStart = now;
+	_nextPowerCheck = now;
+
+	if (_enabled)
+	{
+		CheckPowerState();
+		_nextPowerCheck = now + 
+			_initInfo.PowerCheckInterval * SGB_NANOSECONDS_PER_TICK;
+	}
+}
+
+void SGB_DisplayFrameRateGovernor::RecordFrame(Uint64 frameTime)
+{
+	if (!_enabled)
+	{
+		return;
+	}
+
+	Uint64 interval = SGB_NANOSECONDS_PER_SECOND / _effectiveFrameRate;
+
+	++_windowFrames;
+
+	//half an interval of tolerance before calling it a miss
+	if (frameTime > interval + interval / 2)
+	{
+		++_windowMisses;
+	}
+}
+
+bool SGB_DisplayFrameRateGovernor::Update(Uint64 now)
+{
+	if (!_enabled)
+	{
+		return false;
+	}
+
+	auto previousRate = _effectiveFrameRate;
+	auto previousUnlocked = _unlocked;
+
+	if (now >= _nextPowerCheck)
+	{
+		CheckPowerState();
+		_nextPowerCheck = now + 
+			_initInfo.PowerCheckInterval * SGB_NANOSECONDS_PER_TICK;
+	}
+
+	if (now - _windowStart >= SGB_GOVERNOR_WINDOW)
+	{
+		EvaluateWindow();
+		_windowStart = now;
+	}
+
+	return previousRate != _effectiveFrameRate ||
+		previousUnlocked != _unlocked;
+}
+
+Uint32 SGB_DisplayFrameRateGovernor::GetEffectiveFrameRate()
+{
+	return _effectiveFrameRate;
+}
+
+bool SGB_DisplayFrameRateGovernor::IsFrameRateUnlocked()
+{
+	return _unlocked;
+}
+
+bool SGB_DisplayFrameRateGovernor::IsRunningOnBattery()
+{
+	return _onBattery;
+}
+
+void SGB_DisplayFrameRateGovernor::CheckPowerState()
+{
+	//a rate lowered only by the power state follows the cap back up
+	bool atCap = _effectiveFrameRate == _frameRateCap;
+
+	_onBattery = SDL_GetPowerInfo(NULL, NULL) == SDL_POWERSTATE_ON_BATTERY;
+
+	_unlocked = _initInfo.UnlockFrameRate &&
+		(!_onBattery || _initInfo.UnlockFrameRateOnBattery);
+
+	_frameRateCap = _initInfo.TargetFrameRate;
+
+	if (_onBattery && _initInfo.BatteryFrameRate > 0)
+	{
+		_frameRateCap = std::max(
+			std::min(_initInfo.BatteryFrameRate, _frameRateCap),
+			_initInfo.MinimumFrameRate);
+	}
+
+	//missed deadlines do not matter when unlocked
+	if (atCap || _unlocked)
+	{
+		_effectiveFrameRate = _frameRateCap;
+	}
+	else
+	{
+		_effectiveFrameRate = std::min(_effectiveFrameRate, _frameRateCap);
+	}
+}
+
+void SGB_DisplayFrameRateGovernor::EvaluateWindow()
+{
+	if (_windowFrames > 0 && !_unlocked)
+	{
+		Uint32 missRatio = (_windowMisses * 100) / _windowFrames;
+
+		if (missRatio >= SGB_GOVERNOR_BAD_RATIO)
+		{
+			_goodWindows = 0;
+
+			if (++_badWindows >= SGB_GOVERNOR_BAD_WINDOWS)
+			{
+				_badWindows = 0;
+
+				//step down by a quarter
+				_effectiveFrameRate = std::max(
+					_effectiveFrameRate - _effectiveFrameRate / 4,
+					_initInfo.MinimumFrameRate);
+			}
+		}
+		else if (missRatio <= SGB_GOVERNOR_GOOD_RATIO)
+		{
+			_badWindows = 0;
+
+			if (++_goodWindows >= SGB_GOVERNOR_GOOD_WINDOWS)
+			{
+				_goodWindows = 0;
+
+				//step back up, never above what the power state allows
+				_effectiveFrameRate = std::min(
+					_effectiveFrameRate + std::max(_effectiveFrameRate / 4, (Uint32)1),
+					_frameRateCap);
+			}
+		}
+		else
+		{
+			_badWindows = 0;
+			_goodWindows = 0;
+		}
+	}
+
+	_windowFrames = 0;
+	_windowMisses = 0;
+}
@@ -1,6 +1,10 @@
 #include "SGB_DisplayLoadingManager.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "SGB_LoadingScreen.h"
+#include "SGB_Tracer.h"
 
 SGB_DisplayLoadingManager::SGB_DisplayLoadingManager()
 {
@@ -8,35 +12,93 @@ SGB_DisplayLoadingManager::SGB_DisplayLoadingManager()
 		_currentLoadingScreen =
 		_screenToBeUnloaded =
 		_screenToBeLoaded =
+		_screenToBeUnloadedLater =
+		_pendingScreen =
 		NULL;
 
-	_loadingNextScreen = false;
-	_finishedLoadingScreen.store(false);
+	_loadingStats = {};
 
+	_loadingNextScreen = false;
 	_loadingThread = NULL;
 }
 
 SGB_DisplayLoadingManager::~SGB_DisplayLoadingManager()
 {
-	if (_currentScreen != NULL)
+	Shutdown();
+}
+
+void SGB_DisplayLoadingManager::Shutdown()
+{
+	Stop();
+
+	if (_pendingScreen != NULL && _pendingScreen != _screenToBeLoaded &&
+		!IsPreloaded(_pendingScreen))
+	{
+		delete _pendingScreen;
+	}
+
+	//a preloaded one is deleted below, it must not be found again
+	_pendingScreen = NULL;
+
+	for (auto screen : _preloadedScreens)
+	{
+		if (screen == _screenToBeLoaded)
+		{
+			continue;
+		}
+
+		if (screen->IsLoaded())
+		{
+			screen->UnloadScreen();
+		}
+
+		delete screen;
+	}
+
+	_preloadedScreens.clear();
+
+	for (auto screen : _screenCache)
+	{
+		screen->UnloadScreen();
+		delete screen;
+	}
+
+	_screenCache.clear();
+
+	if (_screenToBeUnloadedLater != NULL)
+	{
+		_screenToBeUnloadedLater->UnloadScreen();
+		delete _screenToBeUnloadedLater;
+		_screenToBeUnloadedLater = NULL;
+	}
+
+	//set (and maybe loaded), but never shown
+	if (_screenToBeLoaded != NULL)
+	{
+		if (_screenToBeLoaded->IsLoaded())
+		{
+			_screenToBeLoaded->UnloadScreen();
+		}
+
+		delete _screenToBeLoaded;
+		_screenToBeLoaded = NULL;
+	}
+
+	//during a transition the loading screen is the current one
+	if (_currentScreen != NULL && _currentScreen != _currentLoadingScreen)
 	{
 		_currentScreen->UnloadScreen();
 		delete _currentScreen;
-		_currentScreen = NULL;
 	}
 
+	_currentScreen = NULL;
+
 	if (_currentLoadingScreen != NULL)
 	{
 		_currentLoadingScreen->UnloadScreen();
 		delete _currentLoadingScreen;
 		_currentLoadingScreen = NULL;
 	}
-
-	if (_loadingThread != NULL)
-	{
-		//delete _loadingThread;
-		_loadingThread = NULL;
-	}
 }
 
 SGB_Screen* SGB_DisplayLoadingManager::GetCurrentScreen()
@@ -44,13 +106,47 @@ SGB_Screen* SGB_DisplayLoadingManager::GetCurrentScreen()
 	return _currentScreen;
 }
 
+SGB_DisplayLoadingStats SGB_DisplayLoadingManager::GetLoadingStats()
+{
+	return _loadingStats;
+}
+
+SGB_LoadingProgress* SGB_DisplayLoadingManager::GetLoadingProgress()
+{
+	return &_progress;
+}
+
+SGB_Screen* SGB_DisplayLoadingManager::FindCachedScreen(const char* name)
+{
+	if (name == NULL)
+	{
+		return NULL;
+	}
+
+	for (auto screen : _screenCache)
+	{
+		if (strcmp(screen->GetScreenName(), name) == 0)
+		{
+			return screen;
+		}
+	}
+
+	return NULL;
+}
+
 void SGB_DisplayLoadingManager::Update()
 {
 	if (_loadingNextScreen)
 	{
-		bool loadFinished = _finishedLoadingScreen.load();
+		bool loadFinished = IsReady(_screenToBeLoaded);
 		bool proceedLoading = false;
 
+		if (loadFinished && _screenToBeLoaded->IsLoadCancelled())
+		{
+			LoadPendingScreen();
+			return;
+		}
+
 		if (_currentScreen != NULL)
 		{
 			auto loadingScreen = (SGB_LoadingScreen*)_currentScreen;
@@ -67,6 +163,19 @@ void SGB_DisplayLoadingManager::Update()
 			FinishLoadingProcess();
 		}
 	}
+	else if (_screenToBeLoaded != NULL && IsPreloaded(_screenToBeLoaded))
+	{
+		SwitchToPreloadedScreen();
+	}
+	else if (_screenToBeLoaded != NULL &&
+		FindCachedScreen(_screenToBeLoaded->GetScreenName()) != NULL)
+	{
+		auto cached = TakeCachedScreen(_screenToBeLoaded);
+
+		_screenToBeLoaded = NULL;
+
+		ShowLoadedScreen(cached);
+	}
 	else if (_screenToBeLoaded != NULL)
 	{
 		PrepareToLoad();
@@ -79,9 +188,317 @@ void SGB_DisplayLoadingManager::SetOwner(SGB_Display * owner)
 	_owner = owner;
 }
 
+void SGB_DisplayLoadingManager::Setup(SGB_DisplayInitInfo info)
+{
+	_initInfo = info;
+
+	if (_initInfo.LoadingHistoryPath != NULL)
+	{
+		_progress.LoadHistory(_initInfo.LoadingHistoryPath);
+	}
+}
+
+int SGB_DisplayLoadingManager::Start()
+{
+	if (_loadingThread != NULL)
+	{
+		return SGB_SUCCESS;
+	}
+
+	_loadingThread = SDL_CreateThread(
+		SGB_DisplayLoadingManager::ExecuteLoadingWorker,
+		"SGB_LoadingThread",
+		(void*)this);
+
+	if (_loadingThread == NULL)
+	{
+		return SGB_FAIL;
+	}
+
+	return SGB_SUCCESS;
+}
+
+void SGB_DisplayLoadingManager::Stop()
+{
+	if (_loadingThread == NULL)
+	{
+		return;
+	}
+
+	SGB_LoadingJob job = { NULL, NULL, true };
+
+	//queued after any pending transition, which is finished first
+	_loadingJobs.push(job);
+
+	SDL_WaitThread(_loadingThread, NULL);
+	_loadingThread = NULL;
+}
+
 void SGB_DisplayLoadingManager::SetScreen(SGB_Screen* screen)
 {
-	_screenToBeLoaded = screen;
+	if (!_loadingNextScreen)
+	{
+		//not started yet, so the latest request simply replaces it
+		if (_screenToBeLoaded != screen)
+		{
+			DiscardRequest(_screenToBeLoaded);
+		}
+
+		_screenToBeLoaded = screen;
+		return;
+	}
+
+	if (screen == _screenToBeLoaded)
+	{
+		//asked again after its load was cancelled, which may already have
+		//given up: the load is let finish and the screen loaded again
+		if (_pendingScreen != NULL && _pendingScreen != screen)
+		{
+			DiscardRequest(_pendingScreen);
+			_pendingScreen = screen;
+		}
+
+		return;
+	}
+
+	//latest request wins: the running load is asked to stop and the
+	//request waits for it, as both would race for the same resources
+	_screenToBeLoaded->CancelLoad();
+
+	//a pending reload of the loading screen is no request of its own
+	if (_pendingScreen != screen && _pendingScreen != _screenToBeLoaded)
+	{
+		DiscardRequest(_pendingScreen);
+	}
+
+	_pendingScreen = screen;
+}
+
+void SGB_DisplayLoadingManager::DiscardRequest(SGB_Screen* screen)
+{
+	//a preloaded screen stays available for a later request
+	if (screen != NULL && !IsPreloaded(screen))
+	{
+		delete screen;
+	}
+}
+
+void SGB_DisplayLoadingManager::LoadPendingScreen()
+{
+	if (_pendingScreen == _screenToBeLoaded)
+	{
+		_pendingScreen = NULL;
+
+		//not ready again until the worker unloads and reloads it
+		_screenToBeLoaded->SetLoaded(false);
+
+		SGB_LoadingJob job = { _screenToBeLoaded, _screenToBeLoaded, false };
+
+		_loadingJobs.push(job);
+		return;
+	}
+
+	//whatever the cancelled load did is undone on the worker thread
+	QueueUnload(_screenToBeLoaded);
+
+	_screenToBeLoaded = _pendingScreen;
+	_pendingScreen = NULL;
+
+	if (_screenToBeLoaded == NULL)
+	{
+		//the latest request was for no screen at all
+		if (_currentScreen != NULL)
+		{
+			_currentScreen->ScreenFinish();
+			_currentScreen = NULL;
+		}
+
+		_loadingNextScreen = false;
+		return;
+	}
+
+	if (IsPreloaded(_screenToBeLoaded))
+	{
+		//already loading (or loaded) by its own preload job
+		_preloadedScreens.erase(std::find(_preloadedScreens.begin(),
+			_preloadedScreens.end(), _screenToBeLoaded));
+	}
+	else if (FindCachedScreen(_screenToBeLoaded->GetScreenName()) != NULL)
+	{
+		_screenToBeLoaded = TakeCachedScreen(_screenToBeLoaded);
+	}
+	else
+	{
+		_screenToBeLoaded->SetLoadingQueue(_currentLoadingScreen);
+
+		SGB_LoadingJob job = { NULL, _screenToBeLoaded, false };
+
+		_loadingJobs.push(job);
+	}
+}
+
+SGB_Screen* SGB_DisplayLoadingManager::TakeCachedScreen(SGB_Screen* requested)
+{
+	auto cached = FindCachedScreen(requested->GetScreenName());
+
+	_screenCache.erase(std::find(_screenCache.begin(),
+		_screenCache.end(), cached));
+
+	//the requested instance was never loaded, the cached one is used instead
+	if (cached != requested)
+	{
+		delete requested;
+	}
+
+	return cached;
+}
+
+void SGB_DisplayLoadingManager::PreloadScreen(SGB_Screen* screen)
+{
+	if (screen == NULL || IsPreloaded(screen))
+	{
+		return;
+	}
+
+	//nobody is watching its progress
+	screen->SetLoadingQueue(NULL);
+
+	_preloadedScreens.push_back(screen);
+
+	SGB_LoadingJob job = { NULL, screen, false };
+
+	_loadingJobs.push(job);
+}
+
+bool SGB_DisplayLoadingManager::IsReady(SGB_Screen* screen)
+{
+	//textures queued by LoadScreen() are counted before it returns
+	return screen->IsLoaded() && !screen->HasPendingUploads();
+}
+
+bool SGB_DisplayLoadingManager::IsPreloaded(SGB_Screen* screen)
+{
+	return std::find(_preloadedScreens.begin(), _preloadedScreens.end(),
+		screen) != _preloadedScreens.end();
+}
+
+void SGB_DisplayLoadingManager::SwitchToPreloadedScreen()
+{
+	//the current screen keeps running until the preload is done
+	if (!IsReady(_screenToBeLoaded))
+	{
+		return;
+	}
+
+	_preloadedScreens.erase(std::find(_preloadedScreens.begin(),
+		_preloadedScreens.end(), _screenToBeLoaded));
+
+	auto screen = _screenToBeLoaded;
+
+	_screenToBeLoaded = NULL;
+
+	ShowLoadedScreen(screen);
+}
+
+void SGB_DisplayLoadingManager::ShowLoadedScreen(SGB_Screen* screen)
+{
+	if (_currentScreen != NULL)
+	{
+		_currentScreen->ScreenFinish();
+
+		if (!CacheScreen(_currentScreen))
+		{
+			UnloadReplacedScreen(_currentScreen, screen);
+		}
+	}
+
+	_currentScreen = screen;
+	_currentScreen->ScreenShow();
+}
+
+bool SGB_DisplayLoadingManager::CacheScreen(SGB_Screen* screen)
+{
+	auto name = screen->GetScreenName();
+
+	if (_initInfo.ScreenCacheBudget == 0 || name == NULL)
+	{
+		return false;
+	}
+
+	//a newer instance replaces the cached one
+	auto previous = FindCachedScreen(name);
+
+	if (previous != NULL)
+	{
+		_screenCache.erase(std::find(_screenCache.begin(),
+			_screenCache.end(), previous));
+
+		QueueUnload(previous);
+	}
+
+	_screenCache.insert(_screenCache.begin(), screen);
+
+	Uint64 usage = 0;
+
+	for (auto cached : _screenCache)
+	{
+		usage += cached->GetMemoryUsage();
+	}
+
+	//evict the least recently used, even the new one if it alone does not fit
+	while (!_screenCache.empty() &&
+		(usage > _initInfo.ScreenCacheBudget ||
+		_screenCache.size() > _initInfo.ScreenCacheMaxScreens))
+	{
+		auto evicted = _screenCache.back();
+
+		_screenCache.pop_back();
+		usage -= evicted->GetMemoryUsage();
+
+		QueueUnload(evicted);
+	}
+
+	return true;
+}
+
+void SGB_DisplayLoadingManager::QueueUnload(SGB_Screen* screen)
+{
+	_owner->DiscardTextureUploads(screen);
+
+	SGB_LoadingJob job = { screen, NULL, false };
+
+	_loadingJobs.push(job);
+}
+
+bool SGB_DisplayLoadingManager::CanDeferUnload(SGB_Screen* previous,
+	SGB_Screen* next)
+{
+	if (!_initInfo.DeferScreenUnload)
+	{
+		return false;
+	}
+
+	if (_initInfo.ScreenMemoryBudget == 0)
+	{
+		return true;
+	}
+
+	//the next screen reports its expected usage before being loaded
+	return previous->GetMemoryUsage() + next->GetMemoryUsage() <=
+		_initInfo.ScreenMemoryBudget;
+}
+
+void SGB_DisplayLoadingManager::UnloadReplacedScreen(SGB_Screen* previous,
+	SGB_Screen* next)
+{
+	Uint64 overlap = previous->GetMemoryUsage() + next->GetMemoryUsage();
+
+	_loadingStats.DeferredUnloads++;
+	_loadingStats.LastOverlapMemory = overlap;
+	_loadingStats.PeakOverlapMemory =
+		std::max(_loadingStats.PeakOverlapMemory, overlap);
+
+	QueueUnload(previous);
 }
 
 void SGB_DisplayLoadingManager::SetLoadingScreen(SGB_Screen* screen)
@@ -108,6 +525,11 @@ void SGB_DisplayLoadingManager::PrepareToLoad()
 	if (_screenToBeUnloaded != NULL)
 	{
 		_screenToBeUnloaded->ScreenFinish();
+
+		if (CacheScreen(_screenToBeUnloaded))
+		{
+			_screenToBeUnloaded = NULL;
+		}
 	}
 
 	//_screenToBeLoaded = screen;
@@ -129,55 +551,104 @@ void SGB_DisplayLoadingManager::PrepareToLoad()
 
 void SGB_DisplayLoadingManager::StartLoadingProcess()
 {
-	if (_loadingThread != NULL)
+	if (_screenToBeUnloaded != NULL)
 	{
-		//delete _loadingThread;
-		_loadingThread = NULL;
+		if (CanDeferUnload(_screenToBeUnloaded, _screenToBeLoaded))
+		{
+			//kept until the next screen is shown
+			_screenToBeUnloadedLater = _screenToBeUnloaded;
+			_screenToBeUnloaded = NULL;
+		}
+		else
+		{
+			_loadingStats.SerialUnloads++;
+		}
 	}
 
-	_loadingThread = SDL_CreateThread(
-		SGB_DisplayLoadingManager::ExecuteLoadingProcess,
-		"SGB_LoadingThread",
-		(void*)this);
+	if (_screenToBeUnloaded != NULL)
+	{
+		_owner->DiscardTextureUploads(_screenToBeUnloaded);
+	}
+
+	SGB_LoadingJob job = 
+		{ _screenToBeUnloaded, _screenToBeLoaded, false };
+
+	//the worker owns the unloaded screen from now on
+	_screenToBeUnloaded = NULL;
+
+	_loadingJobs.push(job);
 }
 
-int SGB_DisplayLoadingManager::ExecuteLoadingProcess(void* data)
+int SGB_DisplayLoadingManager::ExecuteLoadingWorker(void* data)
 {
 	auto t = (SGB_DisplayLoadingManager*)data;
 
-	if (t->_screenToBeUnloaded != NULL)
+	SGB_TRACE_THREAD_NAME("SGB_LoadingThread");
+
+	SGB_LoadingJob job;
+
+	while (true)
 	{
-		t->_screenToBeUnloaded->UnloadScreen();
-		delete t->_screenToBeUnloaded;
-		t->_screenToBeUnloaded = NULL;
-	}
+		t->_loadingJobs.pop(job);
 
-	t->_screenToBeLoaded->SetDisplay(t->_owner);
-	t->_screenToBeLoaded->LoadScreen();
+		if (job.stop)
+		{
+			break;
+		}
 
-	t->_finishedLoadingScreen.store(true);
+		t->ExecuteLoadingProcess(job);
+	}
 
 	return 0;
 }
 
-void SGB_DisplayLoadingManager::FinishLoadingProcess()
+void SGB_DisplayLoadingManager::ExecuteLoadingProcess(SGB_LoadingJob job)
 {
-	if (_screenToBeUnloaded != NULL)
+	if (job.screenToBeUnloaded != NULL)
 	{
-		delete _screenToBeUnloaded;
-		_screenToBeUnloaded = NULL;
+		SGB_TRACE_SCOPE("UnloadScreen");
+
+		job.screenToBeUnloaded->UnloadScreen();
+
+		if (job.screenToBeUnloaded == job.screenToBeLoaded)
+		{
+			//its cancelled load returned, so the cancel can be withdrawn
+			job.screenToBeLoaded->ResetCancelLoad();
+		}
+		else
+		{
+			delete job.screenToBeUnloaded;
+		}
 	}
 
-	if (_loadingThread != NULL)
+	if (job.screenToBeLoaded != NULL)
 	{
-		SDL_WaitThread(_loadingThread, NULL);
+		SGB_TRACE_SCOPE("LoadScreen");
+
+		auto name = job.screenToBeLoaded->GetScreenName();
+
+		job.screenToBeLoaded->SetDisplay(_owner);
+
+		_progress.Begin(name);
+		job.screenToBeLoaded->LoadScreen();
+		_progress.End(name != NULL && !job.screenToBeLoaded->IsLoadCancelled());
+
+		job.screenToBeLoaded->SetLoaded(true);
 	}
+}
 
+void SGB_DisplayLoadingManager::FinishLoadingProcess()
+{
 	_currentScreen = _screenToBeLoaded;
 	_currentScreen->ScreenShow();
 
+	if (_screenToBeUnloadedLater != NULL)
+	{
+		UnloadReplacedScreen(_screenToBeUnloadedLater, _currentScreen);
+		_screenToBeUnloadedLater = NULL;
+	}
+
 	_screenToBeLoaded = NULL;
 
 	_loadingNextScreen = false;
-	_finishedLoadingScreen.store(false);
 }
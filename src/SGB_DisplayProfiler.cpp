@@ -0,0 +1,99 @@
+#include "SGB_DisplayProfiler.h"
+
+//Trace event names, indexed by SGB_FramePhase
+static const char* const SGB_FRAME_PHASE_NAMES[SGB_FRAME_PHASE_COUNT] =
+{
+	"Loading",
+	"Update",
+	"Clear",
+	"BeginDraw",
+	"Draw",
+	"EndDraw",
+	"Present",
+	"Events",
+	"Upload",
+	"Wait"
+};
+
+SGB_DisplayProfiler::SGB_DisplayProfiler()
+{
+	_enabled = false;
+	_tracing = false;
+	_active = false;
+	_startTime = 0;
+	_frameStart = 0;
+	_currentFrame = SGB_FrameProfile();
+}
+
+void SGB_DisplayProfiler::Setup(SGB_DisplayInitInfo info, Uint64 startTime)
+{
+#if SGB_ENABLE_PROFILER
+	_enabled = info.EnableProfiler;
+#else
+	(void)info;
+#endif
+	_startTime = startTime;
+
+	if (_enabled)
+	{
+		_history.reset(SGB_PROFILER_HISTORY_SIZE);
+	}
+}
+
+SGB_FrameProfile SGB_DisplayProfiler::GetLastFrame()
+{
+	if (_history.empty())
+	{
+		return SGB_FrameProfile();
+	}
+
+	return _history.back();
+}
+
+void SGB_DisplayProfiler::GetHistory(std::vector<SGB_FrameProfile>& history)
+{
+	history.resize(_history.size());
+
+	for (size_t i = 0; i < _history.size(); ++i)
+	{
+		history[i] = _history[i];
+	}
+}
+
+void SGB_DisplayProfiler::StartFrame()
+{
+	_currentFrame = SGB_FrameProfile();
+
+	_frameStart = SGB_Clock::GetNanoseconds();
+	_currentFrame.StartNanoseconds = _frameStart - _startTime;
+}
+
+void SGB_DisplayProfiler::FinishPhase(SGB_FramePhase phase)
+{
+	auto now = SGB_Clock::GetNanoseconds();
+
+	_currentFrame.PhaseNanoseconds[phase] += now - _phaseStart[phase];
+
+	if (_tracing)
+	{
+		SGB_Tracer::AddEvent(
+			SGB_FRAME_PHASE_NAMES[phase], _phaseStart[phase], now);
+	}
+}
+
+void SGB_DisplayProfiler::FinishFrame()
+{
+	auto now = SGB_Clock::GetNanoseconds();
+
+	_currentFrame.TotalNanoseconds = now - _frameStart;
+
+	if (_enabled)
+	{
+		_history.push(_currentFrame);
+	}
+
+	if (_tracing)
+	{
+		SGB_Tracer::AddEvent("Frame", _frameStart, now);
+	}
+}
@@ -1,6 +1,33 @@
 #include "SGB_DisplayTimingManager.h"
 
-#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+//Starting guess for how much later than requested the OS wakes up
+const Uint64 SGB_INITIAL_SLEEP_OVERSHOOT = 2 * SGB_NANOSECONDS_PER_TICK;
+
+SGB_DisplayTimingManager::SGB_DisplayTimingManager()
+{
+	_timeSource = new SGB_SystemTimeSource();
+}
+
+SGB_DisplayTimingManager::~SGB_DisplayTimingManager()
+{
+	delete _timeSource;
+}
+
+void SGB_DisplayTimingManager::SetTimeSource(SGB_TimeSource* timeSource)
+{
+	delete _timeSource;
+
+	if (timeSource == NULL)
+	{
+		timeSource = new SGB_SystemTimeSource();
+	}
+
+	_timeSource = timeSource;
+}
 
 void SGB_DisplayTimingManager::Setup(SGB_DisplayInitInfo info)
 {
@@ -9,21 +36,42 @@ void SGB_DisplayTimingManager::Setup(SGB_DisplayInitInfo info)
 
 Uint32 SGB_DisplayTimingManager::StartGlobalTimer()
 {
-	_currentTime = SDL_GetTicks();
+	_startTime = _timeSource->GetNanoseconds();
+	_currentTime = _startTime;
 	_totalElapsed = 0;
 	_loopElapsed = 0;
 	_lastFPSReset = _currentTime;
 	_currentAverageFPS = 0;
+	countedFrames = 0;
+
+	_fpsQueue.reset(_initInfo.FrameRateSamplesPerSecond);
+	_fpsQueueSum = 0;
+
+	_frameTimes.reset(SGB_FRAME_HISTORY_SIZE);
+	_frameTimesSum = 0;
+	_lastFrameDueTime = _currentTime;
+	_frameTime = 0;
 	
-	_frameInterval = (1000 / _initInfo.TargetFrameRate);
+	_governor.Setup(_initInfo, _currentTime);
+
+	_unlockFrameRate = _governor.IsFrameRateUnlocked();
+	_frameInterval = 
+		(SGB_NANOSECONDS_PER_SECOND / _governor.GetEffectiveFrameRate());
+
+	_fixedStepInterval = 
+		(SGB_NANOSECONDS_PER_SECOND / _initInfo.FixedUpdateRate);
+	_fixedAccumulator = 0;
+
+	_sleepOvershoot = SGB_INITIAL_SLEEP_OVERSHOOT;
 	
-	return _currentTime;
+	return GetGlobalTicks();
 }
 
 Uint32 SGB_DisplayTimingManager::CalculateAverageFPS()
 {
 	//Calculate and correct fps
-	Uint32 split = (1000 / _initInfo.FrameRateSamplesPerSecond);
+	Uint64 split = 
+		(SGB_NANOSECONDS_PER_SECOND / _initInfo.FrameRateSamplesPerSecond);
 	
 	auto timeDiff = _currentTime - _lastFPSReset;
 
@@ -33,17 +81,15 @@ Uint32 SGB_DisplayTimingManager::CalculateAverageFPS()
 		
 		_lastFPSReset = _currentTime - spareTime;
 
-		_fpsQueue.insert(_fpsQueue.end(),countedFrames);
-
-		if (_fpsQueue.size() > _initInfo.FrameRateSamplesPerSecond)
+		if (_fpsQueue.full())
 		{
-			_fpsQueue.erase(_fpsQueue.begin());
+			_fpsQueueSum -= _fpsQueue.front();
 		}
 
-		_currentAverageFPS = std::accumulate(
-			_fpsQueue.begin(),
-			_fpsQueue.end(),
-			(Uint32)0);
+		_fpsQueue.push(countedFrames);
+		_fpsQueueSum += countedFrames;
+
+		_currentAverageFPS = _fpsQueueSum;
 
 		countedFrames = 0;
 	}
@@ -51,21 +97,98 @@ Uint32 SGB_DisplayTimingManager::CalculateAverageFPS()
 	return _currentAverageFPS;
 }
 
+SGB_DisplayFrameStats SGB_DisplayTimingManager::CalculateFrameStats()
+{
+	SGB_DisplayFrameStats stats = {};
+
+	auto count = _frameTimes.size();
+
+	if (count == 0)
+	{
+		return stats;
+	}
+
+	_sortedFrameTimes.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		_sortedFrameTimes[i] = _frameTimes[i];
+	}
+
+	std::sort(_sortedFrameTimes.begin(), _sortedFrameTimes.end());
+
+	const double nsToMs = 1.0 / SGB_NANOSECONDS_PER_TICK;
+
+	//nearest-rank percentile
+	auto percentile = [&](double p) -> float {
+		size_t rank = static_cast<size_t>(std::ceil(p * count));
+		return static_cast<float>(
+			_sortedFrameTimes[std::max(rank, (size_t)1) - 1] * nsToMs);
+	};
+
+	stats.SampleCount = static_cast<Uint32>(count);
+	stats.AverageFrameTime = static_cast<float>(
+		(static_cast<double>(_frameTimesSum) / count) * nsToMs);
+	stats.FrameTimeP50 = percentile(0.50);
+	stats.FrameTimeP95 = percentile(0.95);
+	stats.FrameTimeP99 = percentile(0.99);
+	stats.MaxFrameTime = static_cast<float>(
+		_sortedFrameTimes.back() * nsToMs);
+
+	//average of the slowest 1% of the frames (at least one)
+	size_t lowCount = std::max(count / 100, (size_t)1);
+	Uint64 lowSum = 0;
+
+	for (size_t i = count - lowCount; i < count; ++i)
+	{
+		lowSum += _sortedFrameTimes[i];
+	}
+
+	if (lowSum > 0)
+	{
+		stats.OnePercentLowFPS = static_cast<float>(
+			(static_cast<double>(SGB_NANOSECONDS_PER_SECOND) * lowCount) /
+			lowSum);
+	}
+
+	return stats;
+}
+
 Uint32 SGB_DisplayTimingManager::GetGlobalTicks()
 {
-	return _currentTime;
+	return static_cast<Uint32>(
+		GetGlobalNanoseconds() / SGB_NANOSECONDS_PER_TICK);
 }
 
 Uint32 SGB_DisplayTimingManager::GetDeltaTicks()
+{
+	return static_cast<Uint32>(_loopElapsed / SGB_NANOSECONDS_PER_TICK);
+}
+
+Uint64 SGB_DisplayTimingManager::GetGlobalNanoseconds()
+{
+	return _currentTime - _startTime;
+}
+
+Uint64 SGB_DisplayTimingManager::GetDeltaNanoseconds()
 {
 	return _loopElapsed;
 }
 
 void SGB_DisplayTimingManager::UpdateFrameData()
 {
-	auto theTime = SDL_GetTicks();
+	_timeSource->Tick();
+
+	auto theTime = _timeSource->GetNanoseconds();
 	_loopElapsed = theTime - _currentTime;
 	_currentTime = theTime;
+
+	if (_governor.Update(_currentTime))
+	{
+		_unlockFrameRate = _governor.IsFrameRateUnlocked();
+		_frameInterval = 
+			(SGB_NANOSECONDS_PER_SECOND / _governor.GetEffectiveFrameRate());
+	}
 }
 
 bool SGB_DisplayTimingManager::CanRender()
@@ -74,13 +197,17 @@ bool SGB_DisplayTimingManager::CanRender()
 	
 	_totalElapsed += _loopElapsed;
 
-	if (_totalElapsed >= _frameInterval || _initInfo.UnlockFrameRate)
+	if (_totalElapsed >= _frameInterval || _unlockFrameRate)
 	{
-		++countedFrames;
-		
 		result = true;
+
+		//measured from the previous frame that was due, rendered or
+		//not, so a skipped one does not make the next look slow
+		_frameTime = _currentTime - _lastFrameDueTime;
+		_lastFrameDueTime = _currentTime;
 		
-		_totalElapsed -= _frameInterval;
+		//unlocked frames can happen before a whole interval passed
+		_totalElapsed -= std::min(_totalElapsed, _frameInterval);
 
 		//if (_totalElapsed > _frameInterval)
 		//{
@@ -90,3 +217,118 @@ bool SGB_DisplayTimingManager::CanRender()
 	
 	return result;
 }
+
+void SGB_DisplayTimingManager::RecordRenderedFrame()
+{
+	++countedFrames;
+
+	if (_frameTimes.full())
+	{
+		_frameTimesSum -= _frameTimes.front();
+	}
+
+	_frameTimes.push(_frameTime);
+	_frameTimesSum += _frameTime;
+
+	_governor.RecordFrame(_frameTime);
+}
+
+void SGB_DisplayTimingManager::WaitForNextFrame(bool force)
+{
+	//a virtual clock does not move while waiting
+	if ((!force && (!_initInfo.PaceFrames || _unlockFrameRate)) ||
+		!_timeSource->IsRealTime() ||
+		_totalElapsed >= _frameInterval)
+	{
+		return;
+	}
+
+	Uint64 deadline = _currentTime + (_frameInterval - _totalElapsed);
+	Uint64 now = SGB_Clock::GetNanoseconds();
+
+	//coarse sleep, waking up early enough to absorb the usual overshoot
+	while (now + _sleepOvershoot + SGB_NANOSECONDS_PER_TICK < deadline)
+	{
+		Uint64 requested = 
+			(deadline - now - _sleepOvershoot) / SGB_NANOSECONDS_PER_TICK;
+
+		SDL_Delay(static_cast<Uint32>(requested));
+
+		Uint64 after = SGB_Clock::GetNanoseconds();
+		Uint64 slept = after - now;
+		Uint64 overshoot = 0;
+
+		requested *= SGB_NANOSECONDS_PER_TICK;
+
+		if (slept > requested)
+		{
+			overshoot = slept - requested;
+		}
+
+		//react fast to longer wake ups, forget them slowly
+		if (overshoot > _sleepOvershoot)
+		{
+			_sleepOvershoot += (overshoot - _sleepOvershoot) / 2;
+		}
+		else
+		{
+			_sleepOvershoot -= (_sleepOvershoot - overshoot) / 16;
+		}
+
+		now = after;
+	}
+
+	//fine spin for the remaining time
+	while (now < deadline)
+	{
+		std::this_thread::yield();
+		now = SGB_Clock::GetNanoseconds();
+	}
+}
+
+Uint32 SGB_DisplayTimingManager::ConsumeFixedSteps()
+{
+	_fixedAccumulator += _loopElapsed;
+
+	Uint64 steps = _fixedAccumulator / _fixedStepInterval;
+
+	if (steps > _initInfo.MaxUpdateStepsPerFrame)
+	{
+		//too far behind, drop the backlog instead of spiraling
+		steps = _initInfo.MaxUpdateStepsPerFrame;
+		_fixedAccumulator %= _fixedStepInterval;
+	}
+	else
+	{
+		_fixedAccumulator -= steps * _fixedStepInterval;
+	}
+
+	return static_cast<Uint32>(steps);
+}
+
+Uint32 SGB_DisplayTimingManager::GetFixedStepTicks()
+{
+	return static_cast<Uint32>(
+		_fixedStepInterval / SGB_NANOSECONDS_PER_TICK);
+}
+
+Uint64 SGB_DisplayTimingManager::GetFixedStepNanoseconds()
+{
+	return _fixedStepInterval;
+}
+
+Uint32 SGB_DisplayTimingManager::GetEffectiveFrameRate()
+{
+	return _governor.GetEffectiveFrameRate();
+}
+
+bool SGB_DisplayTimingManager::IsFrameRateUnlocked()
+{
+	return _unlockFrameRate;
+}
+
+float SGB_DisplayTimingManager::GetInterpolationAlpha()
+{
+	return static_cast<float>(
+		static_cast<double>(_fixedAccumulator) / _fixedStepInterval);
+}
@@ -0,0 +1,119 @@
+#include "SGB_DrawBatch.h"
+
+#include <algorithm>
+
+#include "SGB_Display.h"
+#include "SGB_types.h"
+
+SGB_DrawBatch::SGB_DrawBatch()
+{
+	_display = NULL;
+}
+
+void SGB_DrawBatch::SetDisplay(SGB_Display* display)
+{
+	_display = display;
+}
+
+void SGB_DrawBatch::FillRect(const SDL_Rect& rect, SDL_Color color)
+{
+	Record(rect, color, false);
+}
+
+void SGB_DrawBatch::DrawRect(const SDL_Rect& rect, SDL_Color color)
+{
+	Record(rect, color, true);
+}
+
+int SGB_DrawBatch::Flush()
+{
+	if (_commands.empty())
+	{
+		return SGB_SUCCESS;
+	}
+
+	std::sort(_commands.begin(), _commands.end(),
+		[](const Command& a, const Command& b) -> bool {
+			return a.key != b.key ? a.key < b.key : a.order < b.order;
+		});
+
+	auto renderer = _display->GetRenderer();
+	auto oldColor = _display->GetDrawColor();
+
+	int result = SGB_SUCCESS;
+
+	_rects.clear();
+
+	for (size_t i = 0; i < _commands.size(); ++i)
+	{
+		_rects.push_back(_commands[i].rect);
+
+		//the group ends on the last command or before a different key
+		if (i + 1 == _commands.size() || _commands[i + 1].key != _commands[i].key)
+		{
+			if (RenderGroup(renderer, _commands[i].key))
+			{
+				result = SGB_FAIL;
+			}
+
+			_rects.clear();
+		}
+	}
+
+	_display->SetDrawColor(oldColor);
+
+	_commands.clear();
+
+	return result;
+}
+
+bool SGB_DrawBatch::IsEmpty()
+{
+	return _commands.empty();
+}
+
+void SGB_DrawBatch::Record(const SDL_Rect& rect, SDL_Color color, bool outline)
+{
+	Command command;
+
+	command.key = ((static_cast<Uint64>(color.r) << 24 |
+		static_cast<Uint64>(color.g) << 16 |
+		static_cast<Uint64>(color.b) << 8 |
+		static_cast<Uint64>(color.a)) << 1) | (outline ? 1 : 0);
+	command.order = static_cast<Uint32>(_commands.size());
+	command.rect = rect;
+
+	_commands.push_back(command);
+}
+
+int SGB_DrawBatch::RenderGroup(SDL_Renderer* renderer, Uint64 key)
+{
+	auto rgba = key >> 1;
+
+	SDL_Color color = {
+		static_cast<Uint8>(rgba >> 24),
+		static_cast<Uint8>(rgba >> 16),
+		static_cast<Uint8>(rgba >> 8),
+		static_cast<Uint8>(rgba)
+	};
+
+	_display->SetDrawColor(color);
+
+	//the shadowed color is only updated when the renderer accepted it
+	auto current = _display->GetDrawColor();
+
+	if (current.r != color.r || current.g != color.g ||
+		current.b != color.b || current.a != color.a)
+	{
+		return SGB_FAIL;
+	}
+
+	auto count = static_cast<int>(_rects.size());
+
+	if (key & 1)
+	{
+		return SDL_RenderDrawRects(renderer, _rects.data(), count) ? SGB_FAIL : SGB_SUCCESS;
+	}
+
+	return SDL_RenderFillRects(renderer, _rects.data(), count) ? SGB_FAIL : SGB_SUCCESS;
+}
@@ -0,0 +1,342 @@
+#include "SGB_JobSystem.h"
+
+#include "SGB_types.h"
+#include "SGB_Tracer.h"
+
+//Index of the calling thread on its SGB_JobSystem, if it is a worker
+static thread_local SGB_JobSystem* t_jobSystem = NULL;
+static thread_local Uint32 t_workerIndex = 0;
+
+SGB_Job::SGB_Job(std::function<void()> function)
+	: _function(function)
+{
+	_pendingDependencies.store(1);
+	_finished.store(false);
+}
+
+bool SGB_Job::IsFinished()
+{
+	return _finished.load();
+}
+
+SGB_JobSystem::SGB_JobSystem()
+{
+	_queuedJobs.store(0);
+	_waitingThreads.store(0);
+	_nextWorker.store(0);
+	_running = false;
+}
+
+SGB_JobSystem::~SGB_JobSystem()
+{
+	Stop();
+}
+
+int SGB_JobSystem::Start(Uint32 workerCount)
+{
+	if (!_workers.empty())
+	{
+		SDL_SetError("The job system is already started");
+		return SGB_FAIL;
+	}
+
+	if (workerCount == 0)
+	{
+		//the main and loading threads also help while waiting
+		int cores = SDL_GetCPUCount();
+		workerCount = cores > 2 ? static_cast<Uint32>(cores - 1) : 1;
+	}
+
+	_running = true;
+
+	for (Uint32 i = 0; i < workerCount; ++i)
+	{
+		auto worker = new Worker();
+
+		worker->owner = this;
+		worker->index = i;
+		worker->thread = NULL;
+
+		_workers.push_back(worker);
+	}
+
+	//the workers are only started with the list complete, as they steal from each other
+	for (auto worker : _workers)
+	{
+		worker->thread = SDL_CreateThread(
+			SGB_JobSystem::ExecuteWorker,
+			"SGB_JobWorker",
+			(void*)worker);
+
+		if (worker->thread == NULL)
+		{
+			Stop();
+			return SGB_FAIL;
+		}
+	}
+
+	return SGB_SUCCESS;
+}
+
+void SGB_JobSystem::Stop()
+{
+	if (_workers.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_running = false;
+	}
+
+	_wakeCondition.notify_all();
+
+	//the workers only finish once every queue is empty
+	for (auto worker : _workers)
+	{
+		if (worker->thread != NULL)
+		{
+			SDL_WaitThread(worker->thread, NULL);
+		}
+	}
+
+	//jobs left behind by a worker that failed to start
+	while (RunNextJob(0)) {}
+
+	for (auto worker : _workers)
+	{
+		delete worker;
+	}
+
+	_workers.clear();
+}
+
+SGB_JobHandle SGB_JobSystem::Submit(std::function<void()> function)
+{
+	return Submit(function, std::vector<SGB_JobHandle>());
+}
+
+SGB_JobHandle SGB_JobSystem::Submit(std::function<void()> function,
+	const std::vector<SGB_JobHandle>& dependencies)
+{
+	SGB_JobHandle job(new SGB_Job(function));
+
+	for (auto& dependency : dependencies)
+	{
+		if (dependency == NULL)
+		{
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(dependency->_mutex);
+
+		if (!dependency->_finished.load())
+		{
+			job->_pendingDependencies.fetch_add(1);
+			dependency->_dependents.push_back(job);
+		}
+	}
+
+	//releases the submission count, the job may be ready already
+	if (job->_pendingDependencies.fetch_sub(1) == 1)
+	{
+		Enqueue(job);
+	}
+
+	return job;
+}
+
+void SGB_JobSystem::Wait(const SGB_JobHandle& job)
+{
+	if (job == NULL)
+	{
+		return;
+	}
+
+	Uint32 workerIndex = (t_jobSystem == this) ? t_workerIndex :
+		_nextWorker.load();
+
+	while (!job->IsFinished())
+	{
+		if (RunNextJob(workerIndex))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_wakeMutex);
+
+		_waitingThreads.fetch_add(1);
+
+		_wakeCondition.wait(lock, [&]() -> bool {
+			return job->IsFinished() || _queuedJobs.load() > 0;
+		});
+
+		_waitingThreads.fetch_sub(1);
+	}
+}
+
+void SGB_JobSystem::Wait(const std::vector<SGB_JobHandle>& jobs)
+{
+	for (auto& job : jobs)
+	{
+		Wait(job);
+	}
+}
+
+Uint32 SGB_JobSystem::GetWorkerCount()
+{
+	return static_cast<Uint32>(_workers.size());
+}
+
+int SGB_JobSystem::ExecuteWorker(void* data)
+{
+	auto worker = (Worker*)data;
+	auto t = worker->owner;
+
+	t_jobSystem = t;
+	t_workerIndex = worker->index;
+
+	SGB_TRACE_THREAD_NAME("SGB_JobWorker");
+
+	while (true)
+	{
+		if (t->RunNextJob(worker->index))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(t->_wakeMutex);
+
+		if (!t->_running && t->_queuedJobs.load() == 0)
+		{
+			break;
+		}
+
+		t->_wakeCondition.wait(lock, [&]() -> bool {
+			return t->_queuedJobs.load() > 0 || !t->_running;
+		});
+	}
+
+	t_jobSystem = NULL;
+
+	return 0;
+}
+
+void SGB_JobSystem::Enqueue(const SGB_JobHandle& job)
+{
+	if (_workers.empty())
+	{
+		RunJob(job);
+		return;
+	}
+
+	Worker* worker = NULL;
+
+	if (t_jobSystem == this)
+	{
+		//keeps the work local, other workers steal it if idle
+		worker = _workers[t_workerIndex];
+	}
+	else
+	{
+		worker = _workers[_nextWorker.fetch_add(1) % _workers.size()];
+	}
+
+	//counted before it can be taken, so RunNextJob() never decrements
+	//the counter below zero
+	_queuedJobs.fetch_add(1);
+
+	{
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		worker->jobs.push_back(job);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+	}
+
+	_wakeCondition.notify_all();
+}
+
+bool SGB_JobSystem::RunNextJob(Uint32 workerIndex)
+{
+	auto count = _workers.size();
+
+	if (count == 0 || _queuedJobs.load() == 0)
+	{
+		return false;
+	}
+
+	SGB_JobHandle job;
+
+	for (size_t i = 0; i < count && job == NULL; ++i)
+	{
+		auto worker = _workers[(workerIndex + i) % count];
+
+		std::lock_guard<std::mutex> lock(worker->mutex);
+
+		if (worker->jobs.empty())
+		{
+			continue;
+		}
+
+		//newest of its own jobs, oldest of the others
+		if (i == 0)
+		{
+			job = worker->jobs.back();
+			worker->jobs.pop_back();
+		}
+		else
+		{
+			job = worker->jobs.front();
+			worker->jobs.pop_front();
+		}
+	}
+
+	if (job == NULL)
+	{
+		return false;
+	}
+
+	_queuedJobs.fetch_sub(1);
+
+	RunJob(job);
+
+	return true;
+}
+
+void SGB_JobSystem::RunJob(const SGB_JobHandle& job)
+{
+	{
+		SGB_TRACE_SCOPE("Job");
+
+		job->_function();
+	}
+
+	std::vector<SGB_JobHandle> dependents;
+
+	{
+		std::lock_guard<std::mutex> lock(job->_mutex);
+
+		job->_finished.store(true);
+		dependents.swap(job->_dependents);
+	}
+
+	for (auto& dependent : dependents)
+	{
+		if (dependent->_pendingDependencies.fetch_sub(1) == 1)
+		{
+			Enqueue(dependent);
+		}
+	}
+
+	if (_waitingThreads.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_wakeMutex);
+		}
+
+		_wakeCondition.notify_all();
+	}
+}
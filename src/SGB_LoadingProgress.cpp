@@ -0,0 +1,310 @@
+#include "SGB_LoadingProgress.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "SGB_Clock.h"
+
+//Progress from which the remaining time is extrapolated when there's no history
+static const float SGB_MIN_PROGRESS_TO_ESTIMATE = 0.05f;
+
+//Smooth progress driven by the elapsed time stops here until the load ends
+static const float SGB_MAX_TIMED_PROGRESS = 0.99f;
+
+SGB_LoadingProgress::SGB_LoadingProgress()
+{
+	for (Uint32 i = 0; i < SGB_LOADING_MAX_TASKS; ++i)
+	{
+		_taskWeights[i] = 0.0f;
+		_taskProgress[i].store(0.0f);
+	}
+
+	_taskCount.store(0);
+	_startTime.store(0);
+	_endTime.store(0);
+	_expectedDuration.store(0);
+	_smoothStartTime = 0;
+	_lastSmoothProgress = 0.0f;
+}
+
+Uint32 SGB_LoadingProgress::AddTask(float weight)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto task = _taskCount.load(std::memory_order_relaxed);
+
+	if (task >= SGB_LOADING_MAX_TASKS)
+	{
+		return SGB_LOADING_MAX_TASKS;
+	}
+
+	_taskWeights[task] = weight > 0.0f ? weight : 0.0f;
+	_taskProgress[task].store(0.0f, std::memory_order_relaxed);
+
+	//the weight must be visible before the task is counted
+	_taskCount.store(task + 1, std::memory_order_release);
+
+	return task;
+}
+
+void SGB_LoadingProgress::SetTaskProgress(Uint32 task, float progress)
+{
+	if (task >= SGB_LOADING_MAX_TASKS)
+	{
+		return;
+	}
+
+	if (progress < 0.0f)
+	{
+		progress = 0.0f;
+	}
+	else if (progress > 1.0f)
+	{
+		progress = 1.0f;
+	}
+
+	_taskProgress[task].store(progress, std::memory_order_relaxed);
+}
+
+float SGB_LoadingProgress::GetProgress()
+{
+	if (_endTime.load() != 0)
+	{
+		return 1.0f;
+	}
+
+	auto count = _taskCount.load(std::memory_order_acquire);
+
+	float totalWeight = 0.0f;
+	float doneWeight = 0.0f;
+
+	for (Uint32 i = 0; i < count; ++i)
+	{
+		totalWeight += _taskWeights[i];
+		doneWeight += _taskWeights[i] *
+			_taskProgress[i].load(std::memory_order_relaxed);
+	}
+
+	if (totalWeight <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	return doneWeight / totalWeight;
+}
+
+float SGB_LoadingProgress::GetSmoothProgress()
+{
+	auto startTime = _startTime.load();
+
+	if (startTime != _smoothStartTime)
+	{
+		_smoothStartTime = startTime;
+		_lastSmoothProgress = 0.0f;
+	}
+
+	auto progress = GetProgress();
+	auto expected = _expectedDuration.load();
+
+	if (expected > 0 && progress < 1.0f)
+	{
+		auto timed = static_cast<float>(
+			static_cast<double>(GetElapsedTicks()) * SGB_NANOSECONDS_PER_TICK / expected);
+
+		if (timed > SGB_MAX_TIMED_PROGRESS)
+		{
+			timed = SGB_MAX_TIMED_PROGRESS;
+		}
+
+		if (timed > progress)
+		{
+			progress = timed;
+		}
+	}
+
+	if (progress > _lastSmoothProgress)
+	{
+		_lastSmoothProgress = progress;
+	}
+
+	return _lastSmoothProgress;
+}
+
+int SGB_LoadingProgress::GetEstimatedRemainingTicks(Uint32* ticks)
+{
+	if (_startTime.load() == 0)
+	{
+		return SGB_FAIL;
+	}
+
+	if (_endTime.load() != 0)
+	{
+		*ticks = 0;
+		return SGB_SUCCESS;
+	}
+
+	auto elapsed = static_cast<Uint64>(GetElapsedTicks()) * SGB_NANOSECONDS_PER_TICK;
+	auto expected = _expectedDuration.load();
+
+	if (expected > elapsed)
+	{
+		*ticks = static_cast<Uint32>((expected - elapsed) / SGB_NANOSECONDS_PER_TICK);
+		return SGB_SUCCESS;
+	}
+
+	//no history, or already slower than it, so only the progress so far is left
+	auto progress = GetProgress();
+
+	if (progress < SGB_MIN_PROGRESS_TO_ESTIMATE)
+	{
+		return SGB_FAIL;
+	}
+
+	*ticks = static_cast<Uint32>(
+		elapsed * (1.0f - progress) / progress / SGB_NANOSECONDS_PER_TICK);
+
+	return SGB_SUCCESS;
+}
+
+Uint32 SGB_LoadingProgress::GetElapsedTicks()
+{
+	auto startTime = _startTime.load();
+
+	if (startTime == 0)
+	{
+		return 0;
+	}
+
+	auto endTime = _endTime.load();
+
+	if (endTime == 0)
+	{
+		endTime = SGB_Clock::GetNanoseconds();
+	}
+
+	return static_cast<Uint32>((endTime - startTime) / SGB_NANOSECONDS_PER_TICK);
+}
+
+void SGB_LoadingProgress::Begin(const char* screenName)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_taskCount.store(0);
+
+	_screenName = screenName != NULL ? screenName : "";
+
+	auto recorded = _history.find(_screenName);
+
+	_expectedDuration.store(
+		screenName != NULL && recorded != _history.end() ? recorded->second : 0);
+
+	_endTime.store(0);
+	_startTime.store(SGB_Clock::GetNanoseconds());
+}
+
+void SGB_LoadingProgress::End(bool record)
+{
+	auto endTime = SGB_Clock::GetNanoseconds();
+
+	_endTime.store(endTime);
+
+	if (!record || _screenName.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto duration = endTime - _startTime.load();
+		auto recorded = _history.find(_screenName);
+
+		if (recorded == _history.end())
+		{
+			_history[_screenName] = duration;
+		}
+		else
+		{
+			//leans on the latest loads, as the game or its data change
+			recorded->second = (recorded->second + duration) / 2;
+		}
+	}
+
+	SaveHistory();
+}
+
+int SGB_LoadingProgress::LoadHistory(const char* filePath)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_historyPath = filePath;
+
+	auto file = fopen(filePath, "r");
+
+	if (file == NULL)
+	{
+		//nothing was recorded yet
+		return SGB_SUCCESS;
+	}
+
+	char line[512];
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		auto separator = strrchr(line, '\t');
+
+		if (separator == NULL)
+		{
+			continue;
+		}
+
+		*separator = '\0';
+
+		unsigned long long ticks = 0;
+
+		if (sscanf(separator + 1, "%llu", &ticks) == 1 && ticks > 0)
+		{
+			_history[line] = static_cast<Uint64>(ticks) * SGB_NANOSECONDS_PER_TICK;
+		}
+	}
+
+	auto failed = ferror(file) != 0;
+
+	fclose(file);
+
+	if (failed)
+	{
+		SDL_SetError("Could not read the loading history file %s", filePath);
+		return SGB_FAIL;
+	}
+
+	return SGB_SUCCESS;
+}
+
+int SGB_LoadingProgress::SaveHistory()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_historyPath.empty())
+	{
+		return SGB_SUCCESS;
+	}
+
+	auto file = fopen(_historyPath.c_str(), "w");
+
+	if (file == NULL)
+	{
+		SDL_SetError("Could not create the loading history file %s", _historyPath.c_str());
+		return SGB_FAIL;
+	}
+
+	for (auto& recorded : _history)
+	{
+		fprintf(file, "%s\t%llu\n", recorded.first.c_str(),
+			static_cast<unsigned long long>(recorded.second / SGB_NANOSECONDS_PER_TICK));
+	}
+
+	fclose(file);
+
+	return SGB_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#include "SGB_LoadingQueue.h"
+
+SGB_LoadingQueue::SGB_LoadingQueue()
+	: _queue(SGB_LOADING_QUEUE_SIZE)
+{
+	_keepHistory.store(true);
+}
+
+bool SGB_LoadingQueue::push(const SGB_LoadingScreenStatus& item)
+{
+	std::lock_guard<std::mutex> lock(_producerMutex);
+
+	_latest.publish(item);
+
+	if (!_keepHistory.load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+
+	return _queue.try_push(item);
+}
+
+bool SGB_LoadingQueue::try_pop(SGB_LoadingScreenStatus& item)
+{
+	return _queue.try_pop(item);
+}
+
+size_t SGB_LoadingQueue::drain(std::vector<SGB_LoadingScreenStatus>& items)
+{
+	return _queue.drain(items);
+}
+
+bool SGB_LoadingQueue::pull_latest(SGB_LoadingScreenStatus& item)
+{
+	return _latest.read(item);
+}
+
+void SGB_LoadingQueue::set_history(bool keepHistory)
+{
+	_keepHistory.store(keepHistory);
+}
+
+bool SGB_LoadingQueue::empty() const
+{
+	return _queue.empty();
+}
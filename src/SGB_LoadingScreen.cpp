@@ -7,7 +7,7 @@ SGB_LoadingScreen::SGB_LoadingScreen()
 
 SGB_LoadingScreen::~SGB_LoadingScreen()
 {
-	if (_statusQueue == NULL)
+	if (_statusQueue != NULL)
 	{
 		delete _statusQueue;
 		_statusQueue = NULL;
@@ -17,10 +17,37 @@ SGB_LoadingScreen::~SGB_LoadingScreen()
 int SGB_LoadingScreen::PullLoadingStatus(
 	SGB_LoadingScreenStatus* status)
 {
-	if (_statusQueue != NULL && !_statusQueue->empty())
+	if (_statusQueue != NULL && _statusQueue->try_pop(*status))
+	{
+		return SGB_SUCCESS;
+	}
+	return SGB_FAIL;
+}
+
+int SGB_LoadingScreen::PullLatestLoadingStatus(
+	SGB_LoadingScreenStatus* status)
+{
+	if (_statusQueue != NULL && _statusQueue->pull_latest(*status))
 	{
-		*status = _statusQueue->pop();
 		return SGB_SUCCESS;
 	}
 	return SGB_FAIL;
 }
+
+size_t SGB_LoadingScreen::DrainLoadingStatus(
+	std::vector<SGB_LoadingScreenStatus>& statuses)
+{
+	if (_statusQueue == NULL)
+	{
+		return 0;
+	}
+	return _statusQueue->drain(statuses);
+}
+
+void SGB_LoadingScreen::SetLoadingStatusHistory(bool keepHistory)
+{
+	if (_statusQueue != NULL)
+	{
+		_statusQueue->set_history(keepHistory);
+	}
+}
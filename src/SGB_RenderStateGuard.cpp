@@ -0,0 +1,19 @@
+#include "SGB_RenderStateGuard.h"
+
+#include "SGB_Display.h"
+
+SGB_RenderStateGuard::SGB_RenderStateGuard(SGB_Display* display)
+{
+	_display = display;
+
+	_drawColor = _display->GetDrawColor();
+	_blendMode = _display->GetBlendMode();
+	_renderTarget = _display->GetRenderTarget();
+}
+
+SGB_RenderStateGuard::~SGB_RenderStateGuard()
+{
+	_display->SetRenderTarget(_renderTarget);
+	_display->SetBlendMode(_blendMode);
+	_display->SetDrawColor(_drawColor);
+}
@@ -0,0 +1,257 @@
+#include "SGB_ResourceManager.h"
+
+#include "SGB_Clock.h"
+
+SGB_Resource::SGB_Resource(const std::string& key)
+	: _key(key)
+{
+	_data = NULL;
+	_size = 0;
+	_references = 1;
+	_loading = true;
+	_releaseTime = 0;
+}
+
+void* SGB_Resource::GetData()
+{
+	return _data;
+}
+
+const char* SGB_Resource::GetKey()
+{
+	return _key.c_str();
+}
+
+Uint64 SGB_Resource::GetSize()
+{
+	return _size;
+}
+
+SGB_ResourceManager::SGB_ResourceManager()
+{
+	_cachedSize = 0;
+}
+
+SGB_ResourceManager::~SGB_ResourceManager()
+{
+	std::vector<SGB_Resource*> resources;
+
+	for (auto& entry : _resources)
+	{
+		resources.push_back(entry.second);
+	}
+
+	_resources.clear();
+	_unreferenced.clear();
+	_cachedSize = 0;
+
+	Unload(resources);
+}
+
+void SGB_ResourceManager::Setup(SGB_DisplayInitInfo info)
+{
+	_initInfo = info;
+}
+
+SGB_Resource* SGB_ResourceManager::Acquire(const char* key,
+	std::function<void*(Uint64*)> load,
+	std::function<void(void*)> unload)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	auto found = _resources.find(key);
+
+	if (found != _resources.end())
+	{
+		auto resource = found->second;
+
+		if (resource->_references++ == 0 && !resource->_loading)
+		{
+			_unreferenced.erase(resource->_unreferencedPosition);
+			_cachedSize -= resource->_size;
+		}
+
+		_loadedCondition.wait(lock, [resource]() -> bool {
+			return !resource->_loading;
+		});
+
+		if (resource->_data == NULL)
+		{
+			DropFailed(resource);
+			return NULL;
+		}
+
+		return resource;
+	}
+
+	auto resource = new SGB_Resource(key);
+
+	_resources[resource->_key] = resource;
+
+	//other threads asking for the same key wait instead of loading it too
+	lock.unlock();
+
+	Uint64 size = 0;
+	auto data = load(&size);
+
+	lock.lock();
+
+	resource->_data = data;
+	resource->_size = size;
+	resource->_unload = unload;
+	resource->_loading = false;
+
+	_loadedCondition.notify_all();
+
+	if (data == NULL)
+	{
+		DropFailed(resource);
+		return NULL;
+	}
+
+	return resource;
+}
+
+SGB_Resource* SGB_ResourceManager::Find(const char* key)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto found = _resources.find(key);
+
+	if (found == _resources.end() ||
+		found->second->_loading ||
+		found->second->_data == NULL)
+	{
+		return NULL;
+	}
+
+	auto resource = found->second;
+
+	if (resource->_references++ == 0)
+	{
+		_unreferenced.erase(resource->_unreferencedPosition);
+		_cachedSize -= resource->_size;
+	}
+
+	return resource;
+}
+
+void SGB_ResourceManager::Release(SGB_Resource* resource)
+{
+	if (resource == NULL)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (--resource->_references > 0)
+	{
+		return;
+	}
+
+	resource->_releaseTime = SGB_Clock::GetNanoseconds();
+
+	_unreferenced.push_front(resource);
+	resource->_unreferencedPosition = _unreferenced.begin();
+	_cachedSize += resource->_size;
+}
+
+void SGB_ResourceManager::Update()
+{
+	std::vector<SGB_Resource*> expired;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (_unreferenced.empty())
+		{
+			return;
+		}
+
+		auto now = SGB_Clock::GetNanoseconds();
+		auto delay = static_cast<Uint64>(_initInfo.ResourceUnloadDelay) * SGB_NANOSECONDS_PER_TICK;
+
+		//the least recently released are at the back
+		while (!_unreferenced.empty())
+		{
+			auto resource = _unreferenced.back();
+
+			auto overBudget = _initInfo.ResourceCacheBudget > 0 &&
+				_cachedSize > _initInfo.ResourceCacheBudget;
+
+			if (!overBudget && now - resource->_releaseTime < delay)
+			{
+				break;
+			}
+
+			_unreferenced.pop_back();
+			_cachedSize -= resource->_size;
+			_resources.erase(resource->_key);
+
+			expired.push_back(resource);
+		}
+	}
+
+	Unload(expired);
+}
+
+void SGB_ResourceManager::Clear()
+{
+	std::vector<SGB_Resource*> unreferenced;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (auto resource : _unreferenced)
+		{
+			_resources.erase(resource->_key);
+			unreferenced.push_back(resource);
+		}
+
+		_unreferenced.clear();
+		_cachedSize = 0;
+	}
+
+	Unload(unreferenced);
+}
+
+Uint64 SGB_ResourceManager::GetCachedSize()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _cachedSize;
+}
+
+Uint32 SGB_ResourceManager::GetResourceCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return static_cast<Uint32>(_resources.size());
+}
+
+void SGB_ResourceManager::DropFailed(SGB_Resource* resource)
+{
+	if (--resource->_references > 0)
+	{
+		return;
+	}
+
+	_resources.erase(resource->_key);
+	delete resource;
+}
+
+void SGB_ResourceManager::Unload(std::vector<SGB_Resource*>& resources)
+{
+	for (auto resource : resources)
+	{
+		if (resource->_data != NULL && resource->_unload)
+		{
+			resource->_unload(resource->_data);
+		}
+
+		delete resource;
+	}
+
+	resources.clear();
+}
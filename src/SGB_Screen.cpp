@@ -1,8 +1,14 @@
 #include "SGB_Screen.h"
 
+#include "SGB_RenderStateGuard.h"
+
 SGB_Screen::SGB_Screen()
 {
 	_display = NULL;
+	_statusQueue = NULL;
+	_loaded.store(false);
+	_loadCancelled.store(false);
+	_pendingUploads.store(0);
 }
 
 SGB_Screen::~SGB_Screen()
@@ -18,36 +24,74 @@ void SGB_Screen::SetDisplay(SGB_Display* display)
 
 void SGB_Screen::FillRect(SDL_Rect rect, SDL_Color color)
 {
-	SDL_Color oldColor = _display->GetDrawColor();
+	auto batch = _display->GetDrawBatch();
+
+	if (batch != NULL)
+	{
+		batch->FillRect(rect, color);
+		return;
+	}
+
+	SGB_RenderStateGuard guard(_display);
 
 	_display->SetDrawColor(color);
 
 	FillRect(rect);
-
-	_display->SetDrawColor(oldColor);
 }
 
 void SGB_Screen::DrawRect(SDL_Rect rect, SDL_Color color)
 {
-	auto oldColor = _display->GetDrawColor();
+	auto batch = _display->GetDrawBatch();
+
+	if (batch != NULL)
+	{
+		batch->DrawRect(rect, color);
+		return;
+	}
+
+	SGB_RenderStateGuard guard(_display);
 
 	_display->SetDrawColor(color);
 
 	DrawRect(rect);
-
-	_display->SetDrawColor(oldColor);
 }
 
 void SGB_Screen::DrawRect(SDL_Rect rect)
 {
+	auto batch = _display->GetDrawBatch();
+
+	if (batch != NULL)
+	{
+		batch->DrawRect(rect, _display->GetDrawColor());
+		return;
+	}
+
 	SDL_RenderDrawRect(_renderer, &rect);
 }
 
 void SGB_Screen::FillRect(SDL_Rect rect)
 {
+	auto batch = _display->GetDrawBatch();
+
+	if (batch != NULL)
+	{
+		batch->FillRect(rect, _display->GetDrawColor());
+		return;
+	}
+
 	SDL_RenderFillRect(_renderer, &rect);
 }
 
+void SGB_Screen::FlushDraws()
+{
+	auto batch = _display->GetDrawBatch();
+
+	if (batch != NULL)
+	{
+		batch->Flush();
+	}
+}
+
 int SGB_Screen::GetRendererSize(int * width, int * height)
 {
 	return SDL_GetRendererOutputSize(_renderer, width, height);
@@ -98,6 +142,77 @@ void SGB_Screen::SetLoadingQueue(SGB_Screen* loadingScreen)
 	}
 }
 
+bool SGB_Screen::IsLoaded()
+{
+	return _loaded.load();
+}
+
+void SGB_Screen::SetLoaded(bool loaded)
+{
+	_loaded.store(loaded);
+}
+
+void SGB_Screen::CancelLoad()
+{
+	_loadCancelled.store(true);
+}
+
+void SGB_Screen::ResetCancelLoad()
+{
+	_loadCancelled.store(false);
+}
+
+bool SGB_Screen::IsLoadCancelled()
+{
+	return _loadCancelled.load();
+}
+
+bool SGB_Screen::HasPendingUploads()
+{
+	return _pendingUploads.load() > 0;
+}
+
+bool SGB_Screen::FinishTextureUpload()
+{
+	return _pendingUploads.fetch_sub(1) == 1;
+}
+
+void SGB_Screen::QueueTextureUpload(SDL_Surface* surface,
+	SDL_Texture** texture)
+{
+	_pendingUploads.fetch_add(1);
+
+	_display->QueueTextureUpload(this, surface, texture);
+}
+
+void SGB_Screen::Invalidate()
+{
+	_display->Invalidate();
+}
+
+void SGB_Screen::Invalidate(SDL_Rect rect)
+{
+	_display->Invalidate(rect);
+}
+
+void SGB_Screen::QueueAtlasUpload(SGB_TextureAtlas* atlas)
+{
+	for (Uint32 i = 0; i < atlas->GetPageCount(); ++i)
+	{
+		auto surface = atlas->TakePageSurface(i);
+
+		if (surface != NULL)
+		{
+			QueueTextureUpload(surface, atlas->GetPageTextureSlot(i));
+		}
+	}
+}
+
+SGB_LoadingProgress* SGB_Screen::GetLoadingProgress()
+{
+	return _display->GetLoadingProgress();
+}
+
 void SGB_Screen::PushLoadingStatus(SGB_LoadingScreenStatus status)
 {
 	if(_statusQueue != NULL)
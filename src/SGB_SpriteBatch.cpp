@@ -0,0 +1,171 @@
+#include "SGB_SpriteBatch.h"
+
+#include "SGB_types.h"
+#include "SGB_TextureAtlas.h"
+
+SGB_SpriteBatch::SGB_SpriteBatch()
+{
+	_renderer = NULL;
+}
+
+void SGB_SpriteBatch::SetRenderer(SDL_Renderer* renderer)
+{
+	_renderer = renderer;
+}
+
+void SGB_SpriteBatch::Draw(SDL_Texture* texture, const SDL_Rect& source,
+	const SDL_Rect& destination, SDL_Color color)
+{
+	if (texture == NULL)
+	{
+		return;
+	}
+
+	Sprite sprite;
+
+	sprite.texture = texture;
+	sprite.source = source;
+	sprite.destination = destination;
+	sprite.color = color;
+
+	_sprites.push_back(sprite);
+}
+
+void SGB_SpriteBatch::Draw(SGB_TextureAtlas* atlas, Uint32 sprite, int x, int y)
+{
+	SGB_AtlasSprite packed;
+
+	if (atlas->GetSprite(sprite, &packed))
+	{
+		return;
+	}
+
+	SDL_Rect destination = { x, y, packed.rect.w, packed.rect.h };
+
+	Draw(atlas->GetPageTexture(packed.page), packed.rect, destination);
+}
+
+void SGB_SpriteBatch::Draw(SGB_TextureAtlas* atlas, Uint32 sprite,
+	const SDL_Rect& destination, SDL_Color color)
+{
+	SGB_AtlasSprite packed;
+
+	if (atlas->GetSprite(sprite, &packed))
+	{
+		return;
+	}
+
+	Draw(atlas->GetPageTexture(packed.page), packed.rect, destination, color);
+}
+
+int SGB_SpriteBatch::Flush()
+{
+	int result = SGB_SUCCESS;
+	size_t first = 0;
+
+	for (size_t i = 1; i <= _sprites.size(); ++i)
+	{
+		//a run ends on the last sprite or before a texture switch
+		if (i == _sprites.size() || _sprites[i].texture != _sprites[first].texture)
+		{
+			if (RenderRun(first, i))
+			{
+				result = SGB_FAIL;
+			}
+
+			first = i;
+		}
+	}
+
+	_sprites.clear();
+
+	return result;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+int SGB_SpriteBatch::RenderRun(size_t first, size_t last)
+{
+	auto texture = _sprites[first].texture;
+
+	int width = 0;
+	int height = 0;
+
+	if (SDL_QueryTexture(texture, NULL, NULL, &width, &height))
+	{
+		return SGB_FAIL;
+	}
+
+	auto scaleU = 1.0f / width;
+	auto scaleV = 1.0f / height;
+
+	_vertices.clear();
+	_indices.clear();
+
+	for (size_t i = first; i < last; ++i)
+	{
+		auto& sprite = _sprites[i];
+
+		auto left = static_cast<float>(sprite.destination.x);
+		auto top = static_cast<float>(sprite.destination.y);
+		auto right = left + sprite.destination.w;
+		auto bottom = top + sprite.destination.h;
+
+		auto u0 = sprite.source.x * scaleU;
+		auto v0 = sprite.source.y * scaleV;
+		auto u1 = (sprite.source.x + sprite.source.w) * scaleU;
+		auto v1 = (sprite.source.y + sprite.source.h) * scaleV;
+
+		auto base = static_cast<int>(_vertices.size());
+
+		SDL_Vertex corners[4] = {
+			{ { left, top }, sprite.color, { u0, v0 } },
+			{ { right, top }, sprite.color, { u1, v0 } },
+			{ { right, bottom }, sprite.color, { u1, v1 } },
+			{ { left, bottom }, sprite.color, { u0, v1 } }
+		};
+
+		_vertices.insert(_vertices.end(), corners, corners + 4);
+
+		int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+
+		_indices.insert(_indices.end(), quad, quad + 6);
+	}
+
+	if (SDL_RenderGeometry(_renderer, texture,
+		_vertices.data(), static_cast<int>(_vertices.size()),
+		_indices.data(), static_cast<int>(_indices.size())))
+	{
+		return SGB_FAIL;
+	}
+
+	return SGB_SUCCESS;
+}
+
+#else
+
+int SGB_SpriteBatch::RenderRun(size_t first, size_t last)
+{
+	auto texture = _sprites[first].texture;
+	int result = SGB_SUCCESS;
+
+	for (size_t i = first; i < last; ++i)
+	{
+		auto& sprite = _sprites[i];
+
+		SDL_SetTextureColorMod(texture, sprite.color.r, sprite.color.g, sprite.color.b);
+		SDL_SetTextureAlphaMod(texture, sprite.color.a);
+
+		if (SDL_RenderCopy(_renderer, texture, &sprite.source, &sprite.destination))
+		{
+			result = SGB_FAIL;
+		}
+	}
+
+	SDL_SetTextureColorMod(texture, 0xff, 0xff, 0xff);
+	SDL_SetTextureAlphaMod(texture, 0xff);
+
+	return result;
+}
+
+#endif
@@ -0,0 +1,333 @@
+#include "SGB_TextureAtlas.h"
+
+#include <algorithm>
+
+#include "SGB_types.h"
+
+//Empty pixels around each sprite, so filtering does not bleed the neighbours in
+static const int SGB_ATLAS_PADDING = 1;
+
+SGB_TextureAtlas::SGB_TextureAtlas(int pageWidth, int pageHeight)
+{
+	_pageWidth = pageWidth;
+	_pageHeight = pageHeight;
+}
+
+SGB_TextureAtlas::~SGB_TextureAtlas()
+{
+	Clear();
+}
+
+Uint32 SGB_TextureAtlas::AddSurface(SDL_Surface* surface)
+{
+	Sprite sprite;
+
+	sprite.surface = surface;
+	sprite.packed.page = 0;
+	sprite.packed.rect = { 0, 0, 0, 0 };
+	sprite.isPacked = false;
+
+	_sprites.push_back(sprite);
+
+	return static_cast<Uint32>(_sprites.size() - 1);
+}
+
+int SGB_TextureAtlas::Pack()
+{
+	std::vector<Uint32> order;
+
+	for (Uint32 i = 0; i < _sprites.size(); ++i)
+	{
+		if (_sprites[i].surface != NULL)
+		{
+			order.push_back(i);
+		}
+	}
+
+	//the tallest first leaves the flattest skylines
+	std::sort(order.begin(), order.end(), [this](Uint32 a, Uint32 b) -> bool {
+		auto heightA = _sprites[a].surface->h;
+		auto heightB = _sprites[b].surface->h;
+
+		return heightA != heightB ? heightA > heightB :
+			_sprites[a].surface->w > _sprites[b].surface->w;
+	});
+
+	for (auto index : order)
+	{
+		auto& sprite = _sprites[index];
+
+		if (sprite.surface->w > _pageWidth || sprite.surface->h > _pageHeight)
+		{
+			SDL_SetError("The sprite %u (%dx%d) does not fit on a %dx%d atlas page",
+				index, sprite.surface->w, sprite.surface->h, _pageWidth, _pageHeight);
+			return SGB_FAIL;
+		}
+
+		//a sprite as large as the page has no neighbour to be padded from
+		auto width = std::min(sprite.surface->w + SGB_ATLAS_PADDING, _pageWidth);
+		auto height = std::min(sprite.surface->h + SGB_ATLAS_PADDING, _pageHeight);
+
+		size_t node = 0;
+		int x = 0;
+		int y = 0;
+		Uint32 pageIndex = 0;
+
+		//the pages of an earlier Pack() call are full of their own sprites
+		while (pageIndex < _pages.size() &&
+			(_pages[pageIndex].surface == NULL ||
+			!FindPosition(_pages[pageIndex], width, height, &node, &x, &y)))
+		{
+			++pageIndex;
+		}
+
+		if (pageIndex == _pages.size())
+		{
+			if (AddPage())
+			{
+				return SGB_FAIL;
+			}
+
+			FindPosition(_pages[pageIndex], width, height, &node, &x, &y);
+		}
+
+		auto& page = _pages[pageIndex];
+
+		PlaceRect(page, node, x, y, width, height);
+
+		SDL_Rect destination = { x, y, sprite.surface->w, sprite.surface->h };
+
+		//copies the alpha as is, instead of blending it with the empty page
+		SDL_SetSurfaceBlendMode(sprite.surface, SDL_BLENDMODE_NONE);
+
+		if (SDL_BlitSurface(sprite.surface, NULL, page.surface, &destination))
+		{
+			return SGB_FAIL;
+		}
+
+		sprite.packed.page = pageIndex;
+		sprite.packed.rect = { x, y, sprite.surface->w, sprite.surface->h };
+		sprite.isPacked = true;
+
+		SDL_FreeSurface(sprite.surface);
+		sprite.surface = NULL;
+	}
+
+	return SGB_SUCCESS;
+}
+
+int SGB_TextureAtlas::CreateTextures(SDL_Renderer* renderer)
+{
+	for (auto& page : _pages)
+	{
+		if (page.texture != NULL || page.surface == NULL)
+		{
+			continue;
+		}
+
+		page.texture = SDL_CreateTextureFromSurface(renderer, page.surface);
+
+		if (page.texture == NULL)
+		{
+			return SGB_FAIL;
+		}
+
+		SDL_FreeSurface(page.surface);
+		page.surface = NULL;
+	}
+
+	return SGB_SUCCESS;
+}
+
+int SGB_TextureAtlas::GetSprite(Uint32 sprite, SGB_AtlasSprite* result)
+{
+	if (sprite >= _sprites.size() || !_sprites[sprite].isPacked)
+	{
+		return SGB_FAIL;
+	}
+
+	*result = _sprites[sprite].packed;
+
+	return SGB_SUCCESS;
+}
+
+Uint32 SGB_TextureAtlas::GetPageCount()
+{
+	return static_cast<Uint32>(_pages.size());
+}
+
+SDL_Texture* SGB_TextureAtlas::GetPageTexture(Uint32 page)
+{
+	return page < _pages.size() ? _pages[page].texture : NULL;
+}
+
+SDL_Surface* SGB_TextureAtlas::TakePageSurface(Uint32 page)
+{
+	if (page >= _pages.size())
+	{
+		return NULL;
+	}
+
+	auto surface = _pages[page].surface;
+
+	_pages[page].surface = NULL;
+	_pages[page].skyline.clear();
+
+	return surface;
+}
+
+SDL_Texture** SGB_TextureAtlas::GetPageTextureSlot(Uint32 page)
+{
+	return page < _pages.size() ? &_pages[page].texture : NULL;
+}
+
+void SGB_TextureAtlas::Clear()
+{
+	for (auto& sprite : _sprites)
+	{
+		if (sprite.surface != NULL)
+		{
+			SDL_FreeSurface(sprite.surface);
+		}
+	}
+
+	for (auto& page : _pages)
+	{
+		if (page.surface != NULL)
+		{
+			SDL_FreeSurface(page.surface);
+		}
+
+		if (page.texture != NULL)
+		{
+			SDL_DestroyTexture(page.texture);
+		}
+	}
+
+	_sprites.clear();
+	_pages.clear();
+}
+
+bool SGB_TextureAtlas::FindPosition(Page& page, int width, int height,
+	size_t* node, int* x, int* y)
+{
+	auto& skyline = page.skyline;
+
+	bool found = false;
+	int bestBottom = 0;
+	int bestWidth = 0;
+
+	for (size_t i = 0; i < skyline.size(); ++i)
+	{
+		auto left = skyline[i].x;
+
+		if (left + width > _pageWidth)
+		{
+			break;
+		}
+
+		//the rectangle rests on the highest node it spans
+		int top = skyline[i].y;
+		int widthLeft = width;
+		size_t j = i;
+
+		while (widthLeft > 0)
+		{
+			top = std::max(top, skyline[j].y);
+			widthLeft -= skyline[j].width;
+			++j;
+		}
+
+		if (top + height > _pageHeight)
+		{
+			continue;
+		}
+
+		//the lowest bottom wins, then the narrowest node, wasting less space
+		if (!found || top + height < bestBottom ||
+			(top + height == bestBottom && skyline[i].width < bestWidth))
+		{
+			found = true;
+			bestBottom = top + height;
+			bestWidth = skyline[i].width;
+
+			*node = i;
+			*x = left;
+			*y = top;
+		}
+	}
+
+	return found;
+}
+
+void SGB_TextureAtlas::PlaceRect(Page& page, size_t node, int x, int y,
+	int width, int height)
+{
+	auto& skyline = page.skyline;
+
+	SkylineNode placed = { x, y + height, width };
+
+	skyline.insert(skyline.begin() + node, placed);
+
+	//the nodes now under the rectangle are shrunk or removed
+	for (size_t i = node + 1; i < skyline.size();)
+	{
+		auto previousRight = skyline[i - 1].x + skyline[i - 1].width;
+
+		if (skyline[i].x >= previousRight)
+		{
+			break;
+		}
+
+		auto shrink = previousRight - skyline[i].x;
+
+		if (skyline[i].width <= shrink)
+		{
+			skyline.erase(skyline.begin() + i);
+			continue;
+		}
+
+		skyline[i].x += shrink;
+		skyline[i].width -= shrink;
+		break;
+	}
+
+	for (size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+int SGB_TextureAtlas::AddPage()
+{
+	Page page;
+
+	page.surface = SDL_CreateRGBSurfaceWithFormat(
+		0,
+		_pageWidth,
+		_pageHeight,
+		32,
+		SDL_PIXELFORMAT_ARGB8888);
+
+	if (page.surface == NULL)
+	{
+		return SGB_FAIL;
+	}
+
+	page.texture = NULL;
+
+	SkylineNode ground = { 0, 0, _pageWidth };
+	page.skyline.push_back(ground);
+
+	_pages.push_back(page);
+
+	return SGB_SUCCESS;
+}
@@ -0,0 +1,39 @@
+#include "SGB_TimeSource.h"
+
+#include "SGB_Clock.h"
+
+Uint64 SGB_SystemTimeSource::GetNanoseconds()
+{
+	return SGB_Clock::GetNanoseconds();
+}
+
+SGB_ManualTimeSource::SGB_ManualTimeSource(Uint64 stepNanoseconds)
+{
+	_currentTime = 0;
+	_step = stepNanoseconds;
+}
+
+Uint64 SGB_ManualTimeSource::GetNanoseconds()
+{
+	return _currentTime;
+}
+
+void SGB_ManualTimeSource::Tick()
+{
+	_currentTime += _step;
+}
+
+bool SGB_ManualTimeSource::IsRealTime()
+{
+	return false;
+}
+
+void SGB_ManualTimeSource::SetStep(Uint64 stepNanoseconds)
+{
+	_step = stepNanoseconds;
+}
+
+void SGB_ManualTimeSource::Advance(Uint64 nanoseconds)
+{
+	_currentTime += nanoseconds;
+}
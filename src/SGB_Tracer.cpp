@@ -0,0 +1,288 @@
+#include "SGB_Tracer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "SGB_types.h"
+#include "SGB_SPSCQueue.h"
+
+//How often the pending events are written to the file
+const Uint32 SGB_TRACE_FLUSH_INTERVAL = 50;
+
+struct SGB_TraceEvent
+{
+	const char* name;
+	Uint64 start;
+	Uint64 end;
+};
+
+//Events recorded by a single thread, waiting to be written
+struct SGB_TraceThreadBuffer
+{
+	explicit SGB_TraceThreadBuffer(Uint32 id) :
+		events(SGB_TRACE_BUFFER_SIZE),
+		threadId(id),
+		threadName(NULL),
+		writtenName(NULL)
+	{
+	}
+
+	SGB_SPSCQueue<SGB_TraceEvent> events;
+
+	Uint32 threadId;
+
+	std::atomic<const char*> threadName;
+
+	//The name already written on the current file (flush side only)
+	const char* writtenName;
+};
+
+//Guards the buffer list and the file
+static std::mutex s_traceMutex;
+
+//The buffers are kept until the process ends, so a thread never
+//holds a dangling pointer to its own buffer
+static std::vector<SGB_TraceThreadBuffer*> s_traceBuffers;
+
+static std::atomic<bool> s_traceActive(false);
+static FILE* s_traceFile = NULL;
+static bool s_traceFirstEvent = true;
+static Uint64 s_traceStartTime = 0;
+
+static SDL_Thread* s_traceFlushThread = NULL;
+static std::mutex s_traceFlushMutex;
+static std::condition_variable s_traceFlushCondition;
+static bool s_traceStopFlush = false;
+
+static thread_local SGB_TraceThreadBuffer* t_traceBuffer = NULL;
+
+//Kept apart from the buffer, so naming a thread costs nothing until it records an event
+static thread_local const char* t_threadName = NULL;
+
+static SGB_TraceThreadBuffer* GetThreadBuffer()
+{
+	if (t_traceBuffer == NULL)
+	{
+		std::lock_guard<std::mutex> lock(s_traceMutex);
+
+		t_traceBuffer = new SGB_TraceThreadBuffer(
+			static_cast<Uint32>(s_traceBuffers.size() + 1));
+
+		t_traceBuffer->threadName.store(t_threadName);
+
+		s_traceBuffers.push_back(t_traceBuffer);
+	}
+
+	return t_traceBuffer;
+}
+
+static void WriteString(const char* text)
+{
+	fputc('"', s_traceFile);
+
+	for (; *text != '\0'; ++text)
+	{
+		if (*text == '"' || *text == '\\')
+		{
+			fputc('\\', s_traceFile);
+		}
+
+		fputc(*text, s_traceFile);
+	}
+
+	fputc('"', s_traceFile);
+}
+
+static void WriteSeparator()
+{
+	fputs(s_traceFirstEvent ? "\n" : ",\n", s_traceFile);
+	s_traceFirstEvent = false;
+}
+
+static double ToTraceTime(Uint64 time)
+{
+	//trace timestamps are in microseconds since the trace started
+	if (time < s_traceStartTime)
+	{
+		return 0;
+	}
+
+	return (time - s_traceStartTime) / 1000.0;
+}
+
+//Must be called with s_traceMutex locked
+static void FlushBuffers()
+{
+	SGB_TraceEvent event;
+
+	for (auto buffer : s_traceBuffers)
+	{
+		const char* name = buffer->threadName.load();
+
+		if (name != NULL && name != buffer->writtenName)
+		{
+			WriteSeparator();
+			fprintf(s_traceFile,
+				"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+				buffer->threadId);
+			WriteString(name);
+			fputs("}}", s_traceFile);
+
+			buffer->writtenName = name;
+		}
+
+		while (buffer->events.try_pop(event))
+		{
+			double start = ToTraceTime(event.start);
+			double end = ToTraceTime(event.end);
+
+			WriteSeparator();
+			fputs("{\"name\":", s_traceFile);
+			WriteString(event.name);
+			fprintf(s_traceFile,
+				",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				buffer->threadId, start, end - start);
+		}
+	}
+
+	fflush(s_traceFile);
+}
+
+static int ExecuteFlushProcess(void* data)
+{
+	(void)data;
+
+	bool stopping = false;
+
+	while (!stopping)
+	{
+		{
+			std::unique_lock<std::mutex> lock(s_traceFlushMutex);
+
+			s_traceFlushCondition.wait_for(lock,
+				std::chrono::milliseconds(SGB_TRACE_FLUSH_INTERVAL),
+				[] { return s_traceStopFlush; });
+
+			stopping = s_traceStopFlush;
+		}
+
+		std::lock_guard<std::mutex> lock(s_traceMutex);
+		FlushBuffers();
+	}
+
+	return 0;
+}
+
+int SGB_Tracer::Start(const char* filePath)
+{
+#if !SGB_ENABLE_TRACER
+	(void)filePath;
+
+	SDL_SetError("The tracer was disabled at compile time");
+	return SGB_FAIL;
+#else
+	std::lock_guard<std::mutex> lock(s_traceMutex);
+
+	if (s_traceFile != NULL)
+	{
+		SDL_SetError("A trace is already being recorded");
+		return SGB_FAIL;
+	}
+
+	s_traceFile = fopen(filePath, "w");
+
+	if (s_traceFile == NULL)
+	{
+		SDL_SetError("Could not create the trace file %s", filePath);
+		return SGB_FAIL;
+	}
+
+	fputs("{\"traceEvents\":[", s_traceFile);
+	s_traceFirstEvent = true;
+	s_traceStartTime = SGB_Clock::GetNanoseconds();
+
+	//discard anything left from a previous trace
+	SGB_TraceEvent event;
+
+	for (auto buffer : s_traceBuffers)
+	{
+		while (buffer->events.try_pop(event)) {}
+		buffer->writtenName = NULL;
+	}
+
+	s_traceStopFlush = false;
+	s_traceActive.store(true);
+
+	s_traceFlushThread = SDL_CreateThread(
+		ExecuteFlushProcess,
+		"SGB_TraceFlushThread",
+		NULL);
+
+	return SGB_SUCCESS;
+#endif
+}
+
+void SGB_Tracer::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_traceMutex);
+
+		if (s_traceFile == NULL)
+		{
+			return;
+		}
+
+		s_traceActive.store(false);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(s_traceFlushMutex);
+		s_traceStopFlush = true;
+	}
+
+	s_traceFlushCondition.notify_one();
+
+	//the flush thread writes everything left before finishing
+	SDL_WaitThread(s_traceFlushThread, NULL);
+	s_traceFlushThread = NULL;
+
+	std::lock_guard<std::mutex> lock(s_traceMutex);
+
+	fputs("\n]}\n", s_traceFile);
+	fclose(s_traceFile);
+	s_traceFile = NULL;
+}
+
+bool SGB_Tracer::IsActive()
+{
+	return s_traceActive.load(std::memory_order_relaxed);
+}
+
+void SGB_Tracer::SetThreadName(const char* name)
+{
+	t_threadName = name;
+
+	//only a thread that already recorded events has a buffer to update
+	if (t_traceBuffer != NULL)
+	{
+		t_traceBuffer->threadName.store(name);
+	}
+}
+
+void SGB_Tracer::AddEvent(const char* name, Uint64 start, Uint64 end)
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	SGB_TraceEvent event = { name, start, end };
+
+	//a full buffer means the flush thread is behind, drop the event
+	//instead of making the caller wait
+	GetThreadBuffer()->events.try_push(event);
+}